@@ -0,0 +1,349 @@
+// Copyright (2025) Hewlett Packard Enterprise Development LP
+// 
+// Licensed under the MIT License (the "License")
+//
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+
+
+// Standalone microbenchmark of the BYOD kernels, independent of SST (build with "make byod_bench").
+// Every kernel is swept over the mesh/vector size and the resolution it depends on and reported as one
+// tab separated line per configuration:
+//
+//   kernel  size  resolution  ns_per_op  allocs_per_op  bytes_per_op
+//
+// size or resolution is 0 if the kernel does not depend on it. The lines are always printed in the same
+// order, so the output of two versions can be compared with diff (allocs_per_op and bytes_per_op are exact,
+// ns_per_op depends on the machine). Heap allocations are counted by Kernels/allocation_counter.cc.
+//
+// usage: byod_bench [-k kernel] [-s sizes] [-r resolutions] [-t min_time_ms]
+//   -k  only run the kernels whose name starts with kernel
+//   -s  comma separated list of sizes, default 4,8,16,32,64,128,256,512
+//   -r  comma separated list of resolutions, default 4,8,12,16
+//   -t  minimum measured time per configuration in ms, default 100
+
+#include "../Kernels/allocation_counter.h"
+#include "../Kernels/adc_kernels.h"
+#include "../Kernels/clements_kernels.h"
+#include "../Kernels/dac_kernels.h"
+#include "../Kernels/modulator_kernels.h"
+#include "../Events/payload_pool.h"
+#include "../CPU/vector_assembler.h"
+#include "../util.h"
+
+#include <chrono>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace SST::BYOD;
+
+namespace {
+
+struct Options {
+	std::string kernel;
+	std::vector<uint32_t> sizes = {4, 8, 16, 32, 64, 128, 256, 512};
+	std::vector<uint32_t> resolutions = {4, 8, 12, 16};
+	double minTime = 0.1; //s
+};
+
+Options options;
+volatile double sink; //keeps the results of kernels without output buffer alive
+
+bool selected(const char* kernel) {
+	return std::strncmp(kernel, options.kernel.c_str(), options.kernel.size()) == 0;
+}
+
+/**
+* @brief time op() and count its heap allocations, opsPerCall is the number of operations done by one call
+* @details the first call is not measured, so workspaces and payload pools reach their steady state.
+* The number of calls is doubled until the calls take at least options.minTime
+*/
+template <typename F>
+void measure(const char* kernel, uint32_t size, uint32_t resolution, F &&op, uint64_t opsPerCall = 1) {
+
+	op();
+
+	for(uint64_t calls = 1; ; calls *= 2) {
+
+		const uint64_t allocations = AllocationCounter::count();
+		const uint64_t bytes = AllocationCounter::bytes();
+		const auto start = std::chrono::steady_clock::now();
+		for(uint64_t i = 0; i < calls; i++)
+			op();
+		const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if(elapsed >= options.minTime) {
+
+			const double ops = double(calls * opsPerCall);
+			std::printf("%s\t%u\t%u\t%.1f\t%.3f\t%.1f\n", kernel, size, resolution, elapsed * 1e9 / ops,
+				(AllocationCounter::count() - allocations) / ops, (AllocationCounter::bytes() - bytes) / ops);
+			std::fflush(stdout);
+			return;
+		}
+	}
+}
+
+std::vector<double> randomValues(size_t n, double min, double max) {
+
+	std::mt19937_64 rng(42);
+	std::uniform_real_distribution<double> dist(min, max);
+	std::vector<double> values(n);
+	for(double &v : values)
+		v = dist(rng);
+	return values;
+}
+
+/**
+* @brief reconstruction of the transfer matrix of a Clements mesh after a weight update (clements, matrix mode)
+*/
+template <typename T>
+void benchReconstruct(const char* kernel, uint32_t size) {
+
+	const std::vector<double> phases = randomValues(ClementsKernels::numPhases(size), 0.0, 2 * M_PI);
+	std::vector<std::complex<T>> matrix(size_t(size) * size);
+
+	measure(kernel, size, 0, [&]() { ClementsKernels::reconstruct(matrix.data(), size, phases.data()); });
+}
+
+/**
+* @brief reconstruction of the full matrix U * S * V of an SVD mesh (clementsSVD, matrix mode)
+* @param checkpoint false: every update rebuilds all stages, true: only U changes and the update starts from the checkpoint of V and S
+*/
+template <typename T>
+void benchReconstructSVD(const char* kernel, uint32_t size, bool checkpoint) {
+
+	const std::vector<double> phasesU = randomValues(ClementsKernels::numPhases(size), 0.0, 2 * M_PI);
+	const std::vector<double> phasesS = randomValues(size, 0.0, 1.0);
+	const std::vector<double> phasesV = randomValues(ClementsKernels::numPhases(size), 0.0, 2 * M_PI);
+	std::vector<std::complex<T>> full(size_t(size) * size);
+	std::vector<std::complex<T>> check(size_t(size) * size);
+	for(uint32_t i = 0; i < size; i++)
+		check[size_t(i) * size + i] = T(1.0);
+
+	const uint32_t firstStage = checkpoint ? size + 2 : 0; //first stage of U
+	if(checkpoint) //advance the checkpoint to the stages of V and S once
+		ClementsKernels::reconstructSVD(full.data(), check.data(), size, phasesU.data(), phasesS.data(), phasesV.data(), 0, firstStage);
+
+	measure(kernel, size, 0, [&]() {
+		ClementsKernels::reconstructSVD(full.data(), checkpoint ? check.data() : nullptr, size,
+										phasesU.data(), phasesS.data(), phasesV.data(), firstStage, firstStage);
+	});
+}
+
+/**
+* @brief propagation of a single vector through the MZI columns of a mesh (clements, layered mode)
+*/
+template <typename T>
+void benchPropagate(const char* kernel, uint32_t size) {
+
+	const std::vector<double> phases = randomValues(ClementsKernels::numPhases(size), 0.0, 2 * M_PI);
+	std::vector<T> rotations(2 * size_t(ClementsKernels::numPhases(size)));
+	ClementsKernels::phaseRotations(phases.data(), size, rotations.data());
+	const ClementsKernels::MeshKernels<T> kernels = ClementsKernels::selectKernels<T>(size);
+
+	std::vector<std::complex<T>> field(size, std::complex<T>(T(1.0 / std::sqrt(size)), T(0.0))); //unit norm, the mesh is unitary
+	measure(kernel, size, 0, [&]() {
+		ClementsKernels::propagateBatch<T>(kernels, field.data(), nullptr, size, 1, rotations.data()); //a single vector needs no workspace
+	});
+}
+
+/**
+* @brief energy table of a DAC (DAC, clements and clementsSVD with a fused weight DAC)
+*/
+void benchDACEnergy(const char* kernel, DACType dacType, double element, uint32_t resolution) {
+
+	measure(kernel, 0, resolution, [&]() {
+		const std::vector<double> table = DACKernels::energyPerValue(dacType, resolution, element, 1.0, 1000.0);
+		sink = table.back();
+	});
+}
+
+/**
+* @brief splitting the memory lines read by the StreamingCPU into data vectors and unpacking the codes (streamingCPU::buffer_data)
+* @details one operation is one data vector, the vectors are streamed in memory lines of 64 bytes and returned
+* to the payload pool like the CPU does when it sends them
+*/
+void benchBufferData(const char* kernel, uint32_t size, uint32_t resolution) {
+
+	const uint32_t vectors = 64;
+	const uint32_t lineBytes = 64;
+	const uint32_t bytesPerElement = (resolution + 7) / 8;
+	const size_t vectorBytes = size_t(size) * bytesPerElement;
+
+	std::vector<uint8_t> stream(vectors * vectorBytes);
+	std::mt19937_64 rng(42);
+	for(uint8_t &b : stream)
+		b = uint8_t(rng());
+
+	VectorAssembler assembler(vectorBytes);
+	std::queue<Payload<uint64_t>> output;
+
+	measure(kernel, size, resolution, [&]() {
+		for(size_t pos = 0; pos < stream.size(); pos += lineBytes)
+			assembler.push(stream.data() + pos, std::min<size_t>(lineBytes, stream.size() - pos), [&](const uint8_t* vectorData) {
+				Payload<uint64_t> out = PayloadPool<uint64_t>::acquire(size);
+				unpackWords(vectorData, size, bytesPerElement, out.data());
+				output.push(std::move(out));
+			});
+		while(!output.empty()) {
+			PayloadPool<uint64_t>::release(std::move(output.front()));
+			output.pop();
+		}
+	}, vectors);
+}
+
+/**
+* @brief quantization of one vector of voltages to codes (ADC), the codes use the word type of a DigitalEvent of the resolution
+*/
+template <typename T>
+void benchQuantize(const char* kernel, uint32_t size, uint32_t resolution) {
+
+	const std::vector<double> voltages = randomValues(size, 0.0, 1.0);
+	std::vector<T> codes(size);
+	const double step = ADCKernels::quantizationStep(0.0, 1.0, resolution);
+
+	const uint64_t maxCode = DigitalKernels::maxCode(resolution);
+
+	measure(kernel, size, resolution, [&]() { ADCKernels::quantize(voltages.data(), codes.data(), size, step, maxCode); });
+}
+
+/**
+* @brief voltage transforms of the modulators: the amplitudes of one data vector (amplitudeModulator) and
+* the phases and heater power of the size * size phase shifters of a mesh (thermo-optic modulator of clements and clementsSVD)
+* @details the in-place kernels are applied to a fresh copy of the voltages, the copy is part of the measured time
+*/
+void benchModulator(uint32_t size) {
+
+	const double resistance = 1e3;
+	const double p_pi = 25e-3;
+	const std::vector<double> voltages = randomValues(size_t(size) * size, 0.0, 5.0);
+	std::vector<double> values(voltages.size());
+
+	if(selected("modulator_amplitudes"))
+		measure("modulator_amplitudes", size, 0, [&]() {
+			std::copy(voltages.begin(), voltages.begin() + size, values.begin());
+			ModulatorKernels::thermoOpticAmplitudes(values.data(), size, resistance, p_pi);
+		});
+
+	if(selected("modulator_phases"))
+		measure("modulator_phases", size, 0, [&]() {
+			std::copy(voltages.begin(), voltages.end(), values.begin());
+			ModulatorKernels::thermoOpticPhases(values.data(), values.size(), resistance, p_pi);
+		});
+
+	if(selected("modulator_heater_power"))
+		measure("modulator_heater_power", size, 0, [&]() { sink = ModulatorKernels::heaterPower(voltages.data(), voltages.size(), resistance); });
+}
+
+std::vector<uint32_t> parseList(const char* str) {
+
+	std::vector<uint32_t> values;
+	for(const char* p = str; *p; ) {
+
+		char* end;
+		const unsigned long value = std::strtoul(p, &end, 10);
+		if(end == p || value == 0 || (*end != ',' && *end != '\0'))
+			return {};
+		values.push_back(uint32_t(value));
+		p = *end ? end + 1 : end;
+	}
+	return values;
+}
+
+bool parseOptions(int argc, char** argv) {
+
+	for(int i = 1; i < argc; i++) {
+
+		if(i + 1 >= argc || argv[i][0] != '-' || std::strlen(argv[i]) != 2)
+			return false;
+		const char* value = argv[++i];
+
+		switch(argv[i - 1][1]) {
+			case 'k': options.kernel = value; break;
+			case 's': options.sizes = parseList(value); break;
+			case 'r': options.resolutions = parseList(value); break;
+			case 't': options.minTime = std::atof(value) * 1e-3; break;
+			default: return false;
+		}
+	}
+	return !options.sizes.empty() && !options.resolutions.empty() && options.minTime > 0;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+
+	if(!parseOptions(argc, argv)) {
+		std::fprintf(stderr, "usage: %s [-k kernel] [-s sizes] [-r resolutions] [-t min_time_ms]\n", argv[0]);
+		return 1;
+	}
+
+	std::printf("kernel\tsize\tresolution\tns_per_op\tallocs_per_op\tbytes_per_op\n");
+
+	for(uint32_t size : options.sizes) {
+
+		if(selected("clements_reconstruct_f64"))
+			benchReconstruct<double>("clements_reconstruct_f64", size);
+		if(selected("clements_reconstruct_f32"))
+			benchReconstruct<float>("clements_reconstruct_f32", size);
+		if(selected("clements_propagate_f64"))
+			benchPropagate<double>("clements_propagate_f64", size);
+		if(selected("clements_propagate_f32"))
+			benchPropagate<float>("clements_propagate_f32", size);
+		if(selected("svd_reconstruct_f64"))
+			benchReconstructSVD<double>("svd_reconstruct_f64", size, false);
+		if(selected("svd_reconstruct_f32"))
+			benchReconstructSVD<float>("svd_reconstruct_f32", size, false);
+		if(selected("svd_update_u_f64"))
+			benchReconstructSVD<double>("svd_update_u_f64", size, true);
+		if(selected("svd_update_u_f32"))
+			benchReconstructSVD<float>("svd_update_u_f32", size, true);
+		benchModulator(size);
+
+		for(uint32_t resolution : options.resolutions) {
+
+			if(selected("cpu_buffer_data"))
+				benchBufferData("cpu_buffer_data", size, resolution);
+			if(!selected("adc_quantize"))
+				continue;
+			if(resolution <= 8)
+				benchQuantize<uint8_t>("adc_quantize", size, resolution);
+			else if(resolution <= 16)
+				benchQuantize<uint16_t>("adc_quantize", size, resolution);
+			else
+				benchQuantize<uint32_t>("adc_quantize", size, resolution);
+		}
+	}
+
+	for(uint32_t resolution : options.resolutions) {
+
+		if(selected("dac_energy_r2r"))
+			benchDACEnergy("dac_energy_r2r", DACType::R2R, 5e3, resolution);
+		if(selected("dac_energy_c2c"))
+			benchDACEnergy("dac_energy_c2c", DACType::C2C, 1e-12, resolution);
+	}
+
+	return 0;
+}
@@ -0,0 +1,119 @@
+#ifndef _memoryImage_H
+#define _memoryImage_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace SST {
+namespace BYOD {
+
+/**
+* @brief Read-only, memory-mapped memory image of the StreamingCPU.
+* @details The file is either a raw byte stream or a .npy file with a one-byte dtype
+* (as written by StreamingCPU.writeMemoryImage in utils/byod_components.py).
+* Pages are only read from disk when they are first touched.
+*/
+class MemoryImage {
+  public:
+	MemoryImage() {}
+	~MemoryImage() { close(); }
+
+	MemoryImage(const MemoryImage &) = delete;
+	MemoryImage &operator=(const MemoryImage &) = delete;
+
+	/**
+	* @brief map a raw or .npy memory image
+	* @details throws std::runtime_error if the file cannot be mapped or is not a valid one-byte .npy file
+	*/
+	void open(const std::string &path) {
+
+		close();
+
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			throw std::runtime_error("cannot open memory image " + path);
+
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			::close(fd);
+			throw std::runtime_error("cannot stat memory image " + path);
+		}
+
+		mappingSize = size_t(st.st_size);
+		if (mappingSize > 0) {
+			mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapping == MAP_FAILED) {
+				mapping = nullptr;
+				::close(fd);
+				throw std::runtime_error("cannot map memory image " + path);
+			}
+		}
+		::close(fd);
+
+		bytes = static_cast<const uint8_t *>(mapping);
+		length = mappingSize;
+
+		if (mappingSize >= 6 && std::memcmp(bytes, "\x93NUMPY", 6) == 0)
+			parseNpyHeader(path);
+	}
+
+	void close() {
+
+		if (mapping)
+			munmap(mapping, mappingSize);
+		mapping = nullptr;
+		mappingSize = 0;
+		bytes = nullptr;
+		length = 0;
+	}
+
+	const uint8_t *data() const { return bytes; }
+	size_t size() const { return length; }
+
+  private:
+	/**
+	* @brief skip the .npy header, only one-dimensional arrays with a one-byte dtype are accepted
+	*/
+	void parseNpyHeader(const std::string &path) {
+
+		if (mappingSize < 10)
+			throw std::runtime_error("truncated .npy header in " + path);
+
+		const uint8_t major = bytes[6];
+		size_t headerLength, offset;
+		if (major == 1) {
+			headerLength = size_t(bytes[8]) | size_t(bytes[9]) << 8;
+			offset = 10;
+		} else {
+			if (mappingSize < 12)
+				throw std::runtime_error("truncated .npy header in " + path);
+			headerLength = size_t(bytes[8]) | size_t(bytes[9]) << 8 | size_t(bytes[10]) << 16 | size_t(bytes[11]) << 24;
+			offset = 12;
+		}
+		if (offset + headerLength > mappingSize)
+			throw std::runtime_error("truncated .npy header in " + path);
+
+		std::string header(reinterpret_cast<const char *>(bytes + offset), headerLength);
+		if (header.find("u1'") == std::string::npos && header.find("i1'") == std::string::npos && header.find("b1'") == std::string::npos)
+			throw std::runtime_error(".npy memory image " + path + " must have a one-byte dtype (uint8)");
+
+		bytes += offset + headerLength;
+		length = mappingSize - offset - headerLength;
+	}
+
+	void *mapping = nullptr;
+	size_t mappingSize = 0;
+	const uint8_t *bytes = nullptr;
+	size_t length = 0;
+};
+} // namespace BYOD
+} // namespace SST
+
+#endif
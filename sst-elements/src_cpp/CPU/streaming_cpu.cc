@@ -39,21 +39,29 @@ streamingCPU::streamingCPU(ComponentId_t id, Params &params) : Component(id) {
 	size = 				params.find<int32_t>("size", 12);
 	resolution = 		params.find<int32_t>("resolution", 8); 
 	verbose = 			params.find<int32_t>("verbose", 0);
+	batchSize = 		params.find<uint32_t>("batchSize", 1);
+	maxOutstandingReads = params.find<uint32_t>("maxOutstandingReads", 10);
+	requestSize = 		params.find<uint32_t>("requestSize", 0);
+	vectorsPerWeightSet = params.find<uint32_t>("vectorsPerWeightSet", 0);
 
-	clockTC = 			registerClock(frequency, new Clock::Handler<streamingCPU>(this, &streamingCPU::clockTick));
+	clockHandler = 		new Clock::Handler<streamingCPU>(this, &streamingCPU::clockTick);
+	clockTC = 			registerClock(frequency, clockHandler);
 	inputLink = 		configureLink("input",	new Event::Handler<streamingCPU>(this, &streamingCPU::handleInput));
 	dataOutputLink = 	configureLink("outputData");
+	creditLink = 		configureLink("creditInput", new Event::Handler<streamingCPU>(this, &streamingCPU::handleCredit));
+	timeoutLink = 		configureSelfLink("timeoutLink", clockTC, new Event::Handler<streamingCPU>(this, &streamingCPU::handleTimeout));
 
 	energyConsumption = registerStatistic<double>("energyCPU"); //currently unused, remove?
 	memory = 			loadUserSubComponent<StandardMem>("memory", ComponentInfo::SHARE_NONE, clockTC, new StandardMem::Handler<streamingCPU>(this, &streamingCPU::handleMemEvent));
 	nanoTimeConverter = getTimeConverter("1ns");
 	picoTimeConverter = getTimeConverter("1ps");
 
-	params.find_array("memory", memory_data);
 	params.find_array("weight_address", weight_addresses);
+	params.find_array("weight_stream_address", weight_stream_addresses);
 	params.find_array("classes", classes);
 
 	num_meshes = weight_addresses.size() / 4; //compute the number of meshes connected to the CPU
+	num_weight_sets = weight_stream_addresses.size() / 5;
 
 	for(int i = 0; i < num_meshes; i++) {
 		weightOutputLink.push_back(configureLink("outputWeight" + std::to_string(i)));
@@ -61,6 +69,29 @@ streamingCPU::streamingCPU(ComponentId_t id, Params &params) : Component(id) {
 
 	std::string prefix = "@t\t@X\t[CPU::" + std::to_string(id) + "]:\t";
 	outputStr.init(prefix, verbose, 0, SST::Output::STDOUT);
+
+	std::string memory_path = params.find<std::string>("memoryFile", "");
+	if(memory_path.empty()) {
+		params.find_array("memory", memory_data);
+		memory_bytes = memory_data.data();
+		memory_size = memory_data.size();
+	}
+	else {
+		try {
+			memory_file.open(memory_path);
+		} catch (const std::runtime_error &e) {
+			outputStr.fatal(CALL_INFO, -1, "Error in %s: %s\n", getName().c_str(), e.what());
+		}
+		memory_bytes = memory_file.data();
+		memory_size = memory_file.size();
+	}
+
+	std::string result_path = params.find<std::string>("resultFile", "");
+	if(!result_path.empty()) {
+		result_file.open(result_path);
+		if(!result_file)
+			outputStr.fatal(CALL_INFO, -1, "Error in %s: unable to open resultFile %s\n", getName().c_str(), result_path.c_str());
+	}
 	
 	if (!memory) {
 		outputStr.fatal(
@@ -70,11 +101,31 @@ streamingCPU::streamingCPU(ComponentId_t id, Params &params) : Component(id) {
 	}
 
 	num_bits = int(ceil(float(resolution) / float(8))) * 8; //number of bits needed to store a data entry with the given resolution
-	data_buffer = std::vector<uint8_t>(size * num_bits, 0); //buffer for collecting data vector after reading from memory
-	buffer_start_index = 0;
+	assembler = VectorAssembler(size * num_bits / 8); //collects data vectors that span several memory lines
 
 	maxAddr = 512 * 1024 * 1024 - 1;
 	vector_counter = 0;
+	dataCredits = 0;
+	clockSuspended = false;
+	next_read_addr = 0;
+	data_bytes = memory_size > addr_data ? memory_size - addr_data : 0;
+
+	Addr weight_addr = (data_bytes + 63) / 64 * 64; //the streamed weight sets are stored behind the data vectors, aligned to the 64 byte init writes
+	for(uint32_t k = 0; k < num_weight_sets; k++) {
+
+		const int32_t *set = &weight_stream_addresses[k * 5];
+		if(set[0] < 0 || set[0] >= num_meshes || set[1] < 0 || set[2] <= 0 || size_t(set[1]) + size_t(set[2]) > memory_size) {
+			outputStr.fatal(
+				CALL_INFO, -1, 
+				"Error in %s: Weight set %u of weight_stream_address targets mesh %d with %d bytes at address %d, but there are %d meshes and %lu bytes of memory\n", 
+				getName().c_str(), k, set[0], set[2], set[1], num_meshes, memory_size);
+		}
+		weight_set_base.push_back(weight_addr);
+		weight_addr += (Addr(set[2]) + 63) / 64 * 64;
+	}
+	weight_set_counter = 0;
+	weight_set_active = false;
+	weight_bytes_received = 0;
 
 	registerAsPrimaryComponent();
 	primaryComponentDoNotEndSim();
@@ -90,6 +141,16 @@ void streamingCPU::setup() {
 
 	memory->setup();
 	line_size = memory->getLineSize();
+
+	if(requestSize == 0)
+		requestSize = line_size > 0 ? line_size : 64; //interfaces without a line size are read in the former fixed chunks of 64 bytes
+	else if(line_size > 0 && requestSize > line_size)
+		outputStr.output(CALL_INFO, "Warning in %s: requestSize of %u bytes is larger than the memory line size of %lu bytes\n", getName().c_str(), requestSize, line_size);
+
+	for(Addr addr = 0; addr < data_bytes; addr += requestSize) //all data vectors are read in chunks of requestSize during the inference operation
+		pending_memory_accesses.push(addr);
+
+	timeoutLink->send(timeoutCycles + 1, new CreditEvent(0)); //the event carries no credits, it only marks the timeout. It arrives after the clock tick of cycle timeoutCycles + 1
 }
 
 void streamingCPU::finish() { }
@@ -107,18 +168,26 @@ void streamingCPU::init(unsigned int phase) {
 	memory->init(phase);
 	if(phase == 0) { // write data vectors during init phase
 
-		int num_chunks = (memory_data.size() - addr_data + 63)  / 64; //compute the number of 64 bit chunks required to send/receive all data vectors
+		int num_chunks = (data_bytes + 63)  / 64; //compute the number of 64 bit chunks required to send/receive all data vectors
 
 		for(int i = 0; i < num_chunks; i++) { //send data vectors in 64 bit chunks
 
 			if(i == num_chunks - 1)
-				memory->sendUntimedData(new SST::Interfaces::StandardMem::Write(i*64, 64, std::vector<uint8_t>(memory_data.begin() + i * 64 + addr_data, memory_data.end())));
+				memory->sendUntimedData(new SST::Interfaces::StandardMem::Write(i*64, 64, std::vector<uint8_t>(memory_bytes + i * 64 + addr_data, memory_bytes + memory_size)));
 			else
-				memory->sendUntimedData(new SST::Interfaces::StandardMem::Write(i*64, 64, std::vector<uint8_t>(memory_data.begin() + i * 64 + addr_data, memory_data.begin() + (i + 1) * 64 + addr_data)));
-			pending_memory_accesses.push(i*64); //add to the list of data chunk that have to be read during the inference operation
+				memory->sendUntimedData(new SST::Interfaces::StandardMem::Write(i*64, 64, std::vector<uint8_t>(memory_bytes + i * 64 + addr_data, memory_bytes + (i + 1) * 64 + addr_data)));
+		}
+		for(uint32_t k = 0; k < num_weight_sets; k++) { //write the streamed weight sets, they are read with timed requests during the simulation
+
+			const uint8_t *weight_bytes = memory_bytes + weight_stream_addresses[k * 5 + 1];
+			const uint64_t num_bytes = weight_stream_addresses[k * 5 + 2];
+			for(uint64_t offset = 0; offset < num_bytes; offset += 64) {
+
+				const uint64_t chunk = std::min<uint64_t>(64, num_bytes - offset);
+				memory->sendUntimedData(new SST::Interfaces::StandardMem::Write(weight_set_base[k] + offset, chunk, std::vector<uint8_t>(weight_bytes + offset, weight_bytes + offset + chunk)));
+			}
 		}
-		std::vector<uint64_t> test(size, 0);
-		dataOutputLink->sendUntimedData(new DigitalEvent(0, resolution, test)); //send an empty event to the dataOutput port to test signal path integretiy
+		dataOutputLink->sendUntimedData(new DigitalEvent(0, resolution, size_t(size))); //send an empty event to the dataOutput port to test signal path integretiy
 	}
 
 	if(phase > 0 && phase <= num_meshes) { //initialize the weights for each mesh
@@ -128,6 +197,19 @@ void streamingCPU::init(unsigned int phase) {
 		weightOutputLink[mesh_index]->sendUntimedData(new DigitalEvent(0, resolution, weights)); //todo???
 	}
 
+	while (SST::Event* ev = creditLink ? creditLink->recvUntimedData() : nullptr) { //initial credits, the queue depth of the downstream component
+
+		CreditEvent* event = dynamic_cast<CreditEvent*>(ev);
+		if (!event) {
+			outputStr.fatal(
+				CALL_INFO, -1, 
+				"Error in %s: Expected creditInput port to be connected to the creditOutput port of a component. Please check the connections of %s\n", 
+				getName().c_str(), getName().c_str());
+		}
+		dataCredits += event->getCredits();
+		delete event;
+	}
+
     while (SST::Event* ev = inputLink->recvUntimedData()) {  // Check if the init event from phase 0 has reveived back at the CPU to verify signal path integrity
 
         DigitalEvent* event = dynamic_cast<DigitalEvent*>(ev);
@@ -144,11 +226,11 @@ void streamingCPU::init(unsigned int phase) {
 				"Error in %s: Digital data received at input port has a resolution of %u bits, while the internal resolution is %u bits. Please make sure that the resolution of connected components is identical by setting the \"resolution\" parameter\n", 
 				getName().c_str(), event->getResolution(), resolution);
 		}
-		if (event->getData().size() != size) { //check for correct size of input vector
+		if (event->getSize() != size) { //check for correct size of input vector
 			outputStr.fatal(
 				CALL_INFO, -1, 
 				"Error in %s: Data received at input port has a size of %u, while the internal size is %u. Please make sure that size of connected components is identical by setting the \"size\" parameter \n", 
-				getName().c_str(), int(event->getData().size()), size);
+				getName().c_str(), int(event->getSize()), size);
 		}
 		if(event)
 			outputStr.verbose(CALL_INFO, 1, 0, "Signal integrity tested, initialization finished \n");
@@ -165,34 +247,77 @@ bool streamingCPU::clockTick(Cycle_t cycle) {
 
 	outputStr.verbose(CALL_INFO, 1, 0, "cycle%lu: \n", cycle);
 
-	if(!pending_memory_accesses.empty()) //check if all memory has been read and read another subchunk of 10 vectors from memory
-		read_stream(10);
+	start_weight_set();
+	if(!pending_memory_accesses.empty() || !pending_weight_accesses.empty()) //keep the window of outstanding reads filled until all memory has been read
+		read_stream();
 	
-	if(!output_buffer.empty()) { //check if there is data in the output buffer and send it to the dataOutput port
+	bool all_read = next_read_addr >= data_bytes;
+	uint64_t batch_limit = std::min<uint64_t>(batchSize, sendable_vectors()); //a batch never spans two weight sets
+	bool credit_available = !creditLink || dataCredits > 0; //without a credit link the downstream component is assumed to always accept data
+	if(credit_available && batch_limit > 0 && (output_buffer.size() >= batch_limit || (all_read && !output_buffer.empty()))) { //check if there is a full batch (or the remaining data) in the output buffer and send it to the dataOutput port
 		
-		dataOutputLink->send(new DigitalEvent(vector_counter, resolution, output_buffer.front()));
+		const uint32_t count = std::min<uint64_t>(output_buffer.size(), batch_limit);
+		DigitalEvent *batch = new DigitalEvent(vector_counter, resolution, size_t(count) * size, count); //the payload is recycled by the events
+		const uint64_t maxCode = DigitalEvent::maxCodeForResolution(resolution);
+		batch->visitCodes([&](auto* codes, size_t) { //the vectors are packed into the word type of the resolution, codes above the resolution saturate like in the DigitalEvent constructor
+			for(uint32_t i = 0; i < count; i++) {
+				DigitalKernels::pack(output_buffer.front().data(), codes + size_t(i) * size, size, maxCode);
+				PayloadPool<uint64_t>::release(std::move(output_buffer.front()));
+				output_buffer.pop();
+			}
+		});
+		dataOutputLink->send(batch);
 		outputStr.verbose(CALL_INFO, 1, 0, "Data sent \n");
-		output_buffer.pop();
-		vector_counter += 1;
+		vector_counter += count;
+		if(creditLink)
+			dataCredits--;
+		start_weight_set(); //the sent vectors may be the first ones of a new weight set
 	}
 
-	if(cycle>20000) { //check for timeout condition to end the simulation in case something breaks
-		outputStr.verbose(CALL_INFO, 1, 0, "Warning: Simulation terminated due to timeout, not all data has been received \n");
-		primaryComponentOKToEndSim();
+	// suspend the clock if neither a read can be issued nor data can be sent, memory responses and credits re-arm it
+	bool can_read = (!pending_memory_accesses.empty() || !pending_weight_accesses.empty()) && memory_requests.size() < maxOutstandingReads;
+	all_read = next_read_addr >= data_bytes;
+	batch_limit = std::min<uint64_t>(batchSize, sendable_vectors());
+	credit_available = !creditLink || dataCredits > 0;
+	bool can_send = credit_available && batch_limit > 0 && (output_buffer.size() >= batch_limit || (all_read && !output_buffer.empty()));
+	if(!can_read && !can_send) {
+		clockSuspended = true;
+		return true;
 	}
 	return false;
 }
 
+/**
+* @brief re-arm the clock at the next clock edge after it was suspended
+*/
+void streamingCPU::resumeClock() {
+
+	if(clockSuspended) {
+		reregisterClock(clockTC, clockHandler);
+		clockSuspended = false;
+	}
+}
+
 
 void streamingCPU::handleInput(Event *ev) {
 
 	DigitalEvent *input = static_cast<DigitalEvent *>(ev);
-	xt::xarray<int32_t> result = xt::adapt(input->getData(), {size});
-
-	outputStr.verbose(CALL_INFO, 1, 0, "Data received \n");
-	std::cout << "Data in: " << result << " " << input->getId() << "  " << vector_count - 1<< std::endl;
+	uint32_t batch = input->getBatchSize();
+
+	outputStr.verbose(CALL_INFO, 1, 0, "Data received, vectors %u to %u of %d\n", input->getId(), input->getId() + batch - 1, vector_count);
+
+	if(result_file.is_open()) { //one line per vector of the batch, the codes are read in the word type of the event
+		input->visitCodes([&](const auto* codes, size_t) {
+			for(uint32_t b = 0; b < batch; b++) {
+				result_file << input->getId() + b;
+				for(uint32_t i = 0; i < size; i++)
+					result_file << "," << uint64_t(codes[size_t(b) * size + i]);
+				result_file << "\n";
+			}
+		});
+	}
 
-	if(input->getId() == ( vector_count - 1)) {
+	if(input->getId() + batch - 1 == ( vector_count - 1)) { //the last vector of a batch has the id getId() + batch - 1
 		outputStr.verbose(CALL_INFO, 1, 0, "all memory operations complete, ending simulation \n");
 		primaryComponentOKToEndSim();
 	}
@@ -201,51 +326,125 @@ void streamingCPU::handleInput(Event *ev) {
 
 }
 
+/**
+* @brief end the simulation in case something breaks and not all data is received
+* @details the timeout is scheduled on a self link in setup(), so it also ends the simulation while the clock is suspended.
+* It fires at the time the clock reaches cycle timeoutCycles + 1, like the former check in clockTick
+*/
+void streamingCPU::handleTimeout(Event *ev) {
+
+	delete ev;
+	outputStr.verbose(CALL_INFO, 1, 0, "Warning: Simulation terminated due to timeout, not all data has been received \n");
+	primaryComponentOKToEndSim();
+}
+
+/**
+* @brief credit returned by the component connected to outputData, one slot of its input queue is free again
+*/
+void streamingCPU::handleCredit(Event *ev) {
+
+	dataCredits += static_cast<CreditEvent *>(ev)->getCredits();
+	delete ev;
+	resumeClock();
+}
+
 /**
 * @brief BRIEF.
 * @details DETAILS
 * @param PARAMETER PARAMETER DESCRIPTION
 * @return RETURN
 */
-void streamingCPU::read_stream(int batch_size) {
+void streamingCPU::read_stream() {
+
+	while(memory_requests.size() < maxOutstandingReads) { //issue reads until the window of outstanding reads is full
 
-	int counter = 0;
-	if(memory_requests.empty()) { //only start a batch request if there are no pending memory reads
+		if(!pending_weight_accesses.empty()) { //weight reads go first, the data vectors of the next weight set wait for them
 
-		while(!pending_memory_accesses.empty() && (counter < batch_size) ) { //queue memory reads until all memory has been read or if the number of requests exceeds the batch size
-			memory->send(createRead(pending_memory_accesses.front(), 64));
+			Addr addr = pending_weight_accesses.front();
+			Addr end = weight_set_base[weight_set_counter] + weight_buffer.size();
+			memory->send(createRead(addr, std::min<uint64_t>(requestSize, end - addr)));
+			pending_weight_accesses.pop();
+		}
+		else if(!pending_memory_accesses.empty()) {
+
+			Addr addr = pending_memory_accesses.front();
+			memory->send(createRead(addr, std::min<uint64_t>(requestSize, data_bytes - addr)));
 			pending_memory_accesses.pop();
-			counter++;
 		}
+		else
+			break;
 	}
 }
 
+/**
+* @brief queue the reads of the next weight set of weight_stream_address
+* @details only one weight set is read at a time. With vectorsPerWeightSet > 0, weight set k is read
+* once the data vectors of weight set k - 1 are being sent, so reading the weights overlaps with the computation
+* and the meshes can stage the set in their shadow buffer before it is used
+*/
+void streamingCPU::start_weight_set() {
+
+	if(weight_set_active || weight_set_counter >= num_weight_sets)
+		return;
+	if(vectorsPerWeightSet > 0 && uint64_t(vector_counter) < uint64_t(weight_set_counter) * vectorsPerWeightSet)
+		return;
+
+	const uint64_t num_bytes = weight_stream_addresses[weight_set_counter * 5 + 2];
+	for(Addr offset = 0; offset < num_bytes; offset += requestSize)
+		pending_weight_accesses.push(weight_set_base[weight_set_counter] + offset);
+
+	weight_buffer.assign(num_bytes, 0);
+	weight_bytes_received = 0;
+	weight_set_active = true;
+	outputStr.verbose(CALL_INFO, 1, 0, "Reading weight set %u\n", weight_set_counter);
+}
+
+/**
+* @brief collect the read responses of the current weight set and send the set to its mesh once all bytes have arrived
+* @details the responses can arrive in any order, each one is copied to its offset in the weight buffer
+*/
+void streamingCPU::buffer_weights(Addr addr, const std::vector<uint8_t> &inData) {
+
+	std::copy(inData.begin(), inData.end(), weight_buffer.begin() + (addr - weight_set_base[weight_set_counter]));
+	weight_bytes_received += inData.size();
+	if(weight_bytes_received < weight_buffer.size())
+		return;
+
+	const int32_t *set = &weight_stream_addresses[weight_set_counter * 5];
+	std::vector<uint64_t> weights = bytes_to_intVector(weight_buffer.data(), set[2], set[3]);
+	uint32_t first_vector = vectorsPerWeightSet > 0 ? (weight_set_counter + 1) * vectorsPerWeightSet : vector_counter; //id of the first data vector computed with this weight set
+	weightOutputLink[set[0]]->send(new DigitalEvent(first_vector, resolution, weights)); //the codes are packed into the event
+	outputStr.verbose(CALL_INFO, 1, 0, "Weight set %u sent to mesh %d for data vector %u on\n", weight_set_counter, set[0], first_vector);
+
+	weight_set_counter++;
+	weight_set_active = false;
+}
+
+/**
+* @brief number of buffered data vectors that can be sent before the next weight set is needed
+*/
+uint64_t streamingCPU::sendable_vectors() {
+
+	if(vectorsPerWeightSet == 0 || weight_set_counter >= num_weight_sets)
+		return UINT64_MAX;
+
+	const uint64_t limit = uint64_t(weight_set_counter + 1) * vectorsPerWeightSet; //vectors from limit on are computed with weight set weight_set_counter
+	return limit > uint64_t(vector_counter) ? limit - vector_counter : 0;
+}
+
 /**
 * @brief BRIEF.
 * @details DETAILS
 * @param PARAMETER PARAMETER DESCRIPTION
 * @return RETURN
 */
-void streamingCPU::buffer_data(std::vector<uint8_t> inData) { //cast and order incoming bits from memory into data vectors
-
-	int32_t byte_index = 0;
-	int32_t bit_index = 0;
-	for (int i = 0; i < 64 * 8; i++) {
+void streamingCPU::buffer_data(const std::vector<uint8_t> &inData) { //cast and order incoming bytes from memory into data vectors
 
-		data_buffer[buffer_start_index] = ((inData[byte_index] >> bit_index ) & 0x01);
-		bit_index = (bit_index + 1) % 8;
-		byte_index = (i + 1) / 8;
-		buffer_start_index = (buffer_start_index + 1 ) % (size * num_bits);
-		
-		if(buffer_start_index == 0) {
-
-			std::vector<uint64_t> out(size, 0);
-			for (int k = 0; k < size * num_bits; k++)
-				out[k / num_bits] |= data_buffer[k] << (k % num_bits);
-
-			output_buffer.push(out);
-		}
-	}
+	assembler.push(inData.data(), inData.size(), [this](const uint8_t *vector_data) { //num_bits is always a multiple of 8, so every element starts at a byte boundary
+		Payload<uint64_t> out = PayloadPool<uint64_t>::acquire(size);
+		unpackWords(vector_data, size, num_bits / 8, out.data());
+		output_buffer.push(std::move(out));
+	});
 }
 
 /**
@@ -256,21 +455,23 @@ void streamingCPU::buffer_data(std::vector<uint8_t> inData) { //cast and order i
 */
 std::vector<uint64_t> streamingCPU::memory_to_intVector(int start_address, int num_bytes, int num_elements, int resolution) {
 
+	return bytes_to_intVector(memory_bytes + start_address, num_bytes, num_elements);
+}
+
+/**
+* @brief unpack num_bytes little-endian bytes into num_elements values of num_bits / 8 bytes each
+*/
+std::vector<uint64_t> streamingCPU::bytes_to_intVector(const uint8_t *bytes, int num_bytes, int num_elements) {
+
 	std::vector<uint64_t> output(num_elements, 0);
 
-	int byte_index = start_address;
-	int bit_index = 0;
-	int element_byte_index = 0;
-	int element_bit_index = 0;
+	const uint32_t bytes_per_element = num_bits / 8;
+	const size_t full_elements = std::min<size_t>(num_elements, num_bytes / bytes_per_element);
+	unpackWords(bytes, full_elements, bytes_per_element, output.data());
 
-	for (int i = 0; i < num_bytes * 8; i++) {
-		output[element_byte_index] |= ((memory_data[byte_index] >> bit_index ) & 0x01) << element_bit_index;
+	for (size_t i = full_elements * bytes_per_element; i < size_t(num_bytes) && full_elements < size_t(num_elements); i++) //trailing bytes of an incomplete element
+		output[full_elements] |= uint64_t(bytes[i]) << (8 * (i % bytes_per_element));
 
-		bit_index = (bit_index + 1) % 8;
-		element_bit_index = (element_bit_index + 1) % num_bits;
-		byte_index = start_address + (i + 1) / 8;
-		element_byte_index = (i + 1) / (num_bits);
-	}
 	return output;
 }
 
@@ -289,8 +490,19 @@ void streamingCPU::handleMemEvent(Req *req) {
 		memory_requests.erase(i);
 
 	SST::Interfaces::StandardMem::ReadResp* event = dynamic_cast<SST::Interfaces::StandardMem::ReadResp*>(req); //try to cast input event to a read response
-	if(event)  //if the event is a read response, buffer the data from the memory
-		buffer_data(event->data);
+	if(event && num_weight_sets > 0 && event->pAddr >= weight_set_base[0]) //the weight sets are stored behind the data vectors
+		buffer_weights(event->pAddr, event->data);
+	else if(event) { //if the event is a read response, buffer the data from the memory in address order
+
+		reorder_buffer[event->pAddr] = std::move(event->data);
+
+		for(auto it = reorder_buffer.begin(); it != reorder_buffer.end() && it->first == next_read_addr; it = reorder_buffer.erase(it)) {
+			buffer_data(it->second);
+			next_read_addr += it->second.size();
+		}
+	}
+	delete req;
+	resumeClock();
 	
 	outputStr.verbose(CALL_INFO, 1, 0, "Memory operation done.\n");
 }
@@ -3,8 +3,12 @@
 
 #include "../Events/digital_event.h"
 #include "../Events/analog_event.h"
+#include "../Events/credit_event.h"
+#include "memory_image.h"
+#include "vector_assembler.h"
 
 #include <cstdint>
+#include <fstream>
 #include <vector>
 #include <cmath>
 #include <util.h>
@@ -55,12 +59,20 @@ class streamingCPU : public SST::Component {
 		{"vectorCount", 	"(uint32) total optical intensity loss of the mesh in percentage", "0"},
 		{"vectorBaseAddr", 	"(uint32) total optical intensity loss of the mesh in percentage", "0"},
 		{"frequency", 		"(double) maximal input voltage for the phase shifters in V", "0"},
+		{"batchSize", 		"(uint32) number of data vectors sent in a single (batched) event", "1"},
+		{"maxOutstandingReads", "(uint32) maximal number of memory reads in flight, new reads are issued as soon as one completes", "10"},
+		{"memoryFile", 		"(string) path to a raw or .npy (uint8) memory image, replaces the memory parameter. The file is memory-mapped and read during init", ""},
+		{"requestSize", 	"(uint32) size of a single memory read in bytes, 0 uses the line size of the memory interface (64 if the interface reports no line size)", "0"},
+		{"weight_stream_address", "(vector<int32>) weight sets streamed during the simulation, 5 entries per set: [mesh index, start address, number of bytes, number of elements, resolution]", "[]"},
+		{"resultFile", 		"(string) path of a CSV file the received result vectors are written to, one line \"id,code0,code1,...\" per vector, empty to not write results", ""},
+		{"vectorsPerWeightSet", "(uint32) number of data vectors computed with each weight set. Weight set k of weight_stream_address is used from data vector (k + 1) * vectorsPerWeightSet on, data vectors are held back until their weight set has been sent. 0 streams the weight sets back to back without holding back data", "0"},
 	);
 
 	SST_ELI_DOCUMENT_PORTS(
 		{"input", 				"receiving input signal (digital)", {"sst.byod.digitalEvent"}},
+		{"creditInput", 		"optional, receiving credits from the component connected to outputData. If connected, data is only sent while credits are available", {"sst.byod.creditEvent"}},
 		{"outputData", 			"sending data output signal (digital)", {"sst.byod.digitalEvent"}},
-		{"outputWeight%d", 		"sending weight output signal (digital)", {"sst.byod.digitalEvent"}}
+		{"outputWeight%d", 		"sending weight output signal (digital), untimed during init and timed for the sets in weight_stream_address. The id of a timed weight set is the first data vector it is used for", {"sst.byod.digitalEvent"}}
 	);
 
 	SST_ELI_DOCUMENT_STATISTICS(
@@ -79,6 +91,9 @@ class streamingCPU : public SST::Component {
 	bool clockTick(Cycle_t cycle);
 	void init(unsigned int phase) override;
 	void handleInput(Event *ev);
+	void handleCredit(Event *ev);
+	void handleTimeout(Event *ev);
+	void resumeClock();
 	void handleMemEvent(Req *ev);
 
   private:
@@ -90,6 +105,8 @@ class streamingCPU : public SST::Component {
 
 	Link *inputLink;
 	Link *dataOutputLink;
+	Link *creditLink;
+	Link *timeoutLink; //self link that ends the simulation after timeoutCycles, independent of the clock
 	std::vector<Link*> weightOutputLink;
 	std::vector<Link*> biasOutputLink;
 
@@ -103,7 +120,11 @@ class streamingCPU : public SST::Component {
 	SST::RNG::MarsagliaRNG rng;
 	uint32_t resolution;
 	uint32_t num_bits;
+	uint32_t batchSize;
+	uint32_t maxOutstandingReads;
+	uint32_t requestSize;
 	Addr addr_data;
+	uint32_t vectorsPerWeightSet;
 
 	/** Statistics *********************************************/
 
@@ -111,27 +132,51 @@ class streamingCPU : public SST::Component {
 
 	/** operation *********************************************/
 
+	uint32_t dataCredits; //number of events the component connected to outputData can still accept
 	uint64_t maxAddr;
 	uint64_t line_size;
 	TimeConverter *nanoTimeConverter;
 	TimeConverter *picoTimeConverter;
 	TimeConverter *clockTC;
+	Clock::HandlerBase *clockHandler;
+	bool clockSuspended; //the clock is unregistered while the CPU waits for memory responses or credits
 	const double_t memory_request_width = 64;
+	const Cycle_t timeoutCycles = 20000; //the simulation ends after this many clock cycles even if not all data has been received
 
 	std::queue<Addr> pending_memory_accesses;
-	std::queue<std::vector<uint64_t>> output_buffer;
+	std::map<Addr, std::vector<uint8_t>> reorder_buffer; //read responses that arrived ahead of next_read_addr
+	Addr next_read_addr; //address of the next memory line handed to buffer_data
+	uint64_t data_bytes; //number of bytes of the data vectors in memory
+	std::queue<Payload<uint64_t>> output_buffer;
 
 	std::map<Interfaces::StandardMem::Request::id_t, std::pair<SimTime_t, std::string>>	memory_requests;
 
-	std::vector<uint8_t> memory_data;
+	std::vector<uint8_t> memory_data; //memory image passed as memory parameter
+	MemoryImage memory_file; //memory image mapped from memoryFile
+	const uint8_t *memory_bytes; //memory image used by the CPU, points to memory_data or memory_file
+	size_t memory_size;
 	std::vector<int32_t> weight_addresses;
+	std::vector<int32_t> weight_stream_addresses;
 	std::vector<int32_t> bias_addresses;
 	std::vector<int32_t> sigma_addresses;
 
 	int32_t num_meshes;
 	int32_t num_ALU;
 
+	uint32_t num_weight_sets; //number of weight sets streamed during the simulation
+	std::vector<Addr> weight_set_base; //memory address of each streamed weight set, the sets are stored after the data vectors
+	uint32_t weight_set_counter; //next weight set to be read, all sets before it have been sent
+	bool weight_set_active; //the reads of a weight set are in flight
+	std::queue<Addr> pending_weight_accesses;
+	std::vector<uint8_t> weight_buffer; //bytes of the weight set that is currently read
+	uint64_t weight_bytes_received;
+
 	std::vector<uint64_t> memory_to_intVector(int start_address, int num_bytes, int num_elements, int resolution);
+	std::vector<uint64_t> bytes_to_intVector(const uint8_t *bytes, int num_bytes, int num_elements);
+
+	void start_weight_set();
+	void buffer_weights(Addr addr, const std::vector<uint8_t> &inData);
+	uint64_t sendable_vectors();
 
 	Req *createRead(Addr addr, size_t size);
 
@@ -151,14 +196,14 @@ class streamingCPU : public SST::Component {
 	 */
 	void sendMemWrite(std::vector<uint8_t> data, Addr addr);
 
-	void read_stream(int batch_size);
+	void read_stream();
 
-	std::vector<uint8_t> data_buffer;
+	VectorAssembler assembler; //splits the memory lines into data vectors
+	std::ofstream result_file; //received result vectors, only open if resultFile is set
 	std::vector<int32_t> classes;
 	int32_t vector_count;
-	int32_t buffer_start_index;
 	int32_t vector_counter;
-	void buffer_data(std::vector<uint8_t> inData);
+	void buffer_data(const std::vector<uint8_t> &inData);
 };
 } // namespace BYOD
 } // namespace SST
@@ -0,0 +1,62 @@
+#ifndef _vectorAssembler_H
+#define _vectorAssembler_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SST {
+namespace BYOD {
+
+/**
+* @brief Splits the byte stream read from memory into data vectors of a fixed number of bytes.
+* @details Memory lines and data vectors are not aligned, a vector can start in the middle of a line
+* and span several lines. Vectors that lie within one line are handed out directly from the line,
+* only vectors that span several lines are collected in the internal buffer first.
+*/
+class VectorAssembler {
+  public:
+	VectorAssembler() {}
+	explicit VectorAssembler(size_t vectorBytes) : buffer(vectorBytes, 0), filled(0) {}
+
+	/**
+	* @brief append n bytes to the stream and call onVector(const uint8_t* vector) for every completed vector
+	*/
+	template <typename F>
+	void push(const uint8_t *bytes, size_t n, F &&onVector) {
+
+		const size_t vector_bytes = buffer.size();
+		size_t pos = 0;
+
+		while(pos < n) {
+
+			const uint8_t *vector_data = bytes + pos;
+
+			if(filled == 0 && n - pos >= vector_bytes) //the whole vector is in the memory line, unpack it directly
+				pos += vector_bytes;
+			else { //the vector spans several memory lines, collect its bytes first
+				size_t chunk = std::min(n - pos, vector_bytes - filled);
+				std::copy(bytes + pos, bytes + pos + chunk, buffer.begin() + filled);
+				pos += chunk;
+				filled += chunk;
+
+				if(filled < vector_bytes)
+					break;
+
+				vector_data = buffer.data();
+				filled = 0;
+			}
+
+			onVector(vector_data);
+		}
+	}
+
+  private:
+	std::vector<uint8_t> buffer; //bytes of the data vector that is currently assembled
+	size_t filled = 0;
+};
+} // namespace BYOD
+} // namespace SST
+
+#endif
@@ -2,6 +2,12 @@
 
 #include <sst/core/event.h>
 
+#include "payload_pool.h"
+#include "payload_serialization.h"
+#include "precision.h"
+
+#include <type_traits>
+
 namespace SST {
 namespace BYOD {
 
@@ -11,26 +17,90 @@ class AnalogEvent : public Event {
 		Event::serialize_order(ser);
 		ser & id;
 		ser & max;
-		ser & data;
+		serializePayload(ser, data);
+		serializePayload(ser, dataSingle);
+		ser & singlePrecision;
+		ser & batchSize;
 	}
 
-	AnalogEvent(uint32_t id, double max, std::vector<double> data) //constructor
+	/**
+	* @param data batchSize vectors stored one after another in a single contiguous, aligned buffer
+	* @param batchSize number of vectors carried by the event, the vectors have the ids id ... id + batchSize - 1
+	*/
+	AnalogEvent(uint32_t id, double max, Payload<double> data, uint32_t batchSize = 1) //constructor
+		: Event(),
+		id(id),
+		max(max), 
+		data(std::move(data)),
+		singlePrecision(false),
+		batchSize(batchSize)
+	{}
+
+	/**
+	* @brief single precision payload, see precision.h
+	*/
+	AnalogEvent(uint32_t id, double max, Payload<float> data, uint32_t batchSize = 1) //constructor
 		: Event(),
 		id(id),
 		max(max), 
-		data(data)
+		dataSingle(std::move(data)),
+		singlePrecision(true),
+		batchSize(batchSize)
 	{}
 
-	uint32_t getId() { return id; }
-	double getMax() { return max; }
-	std::vector<double> getData() { return data; }
+	~AnalogEvent() { //the payload is recycled unless it was released
+		PayloadPool<double>::release(std::move(data));
+		PayloadPool<float>::release(std::move(dataSingle));
+	}
+
+	uint32_t getId() const { return id; }
+	double getMax() const { return max; }
+	uint32_t getBatchSize() const { return batchSize; }
+	bool isSinglePrecision() const { return singlePrecision; }
+	size_t getSize() const { return singlePrecision ? dataSingle.size() : data.size(); }
+
+	/**
+	* @brief payload of the given scalar type, empty if the event has the other precision
+	*/
+	template <typename T = double>
+	const Payload<T>& getData() const {
+		if constexpr (std::is_same<T, float>::value)
+			return dataSingle;
+		else
+			return data;
+	}
+
+	/**
+	* @brief move the payload out of the event, e.g. to reuse it as buffer of the output event. The event is empty afterwards
+	*/
+	template <typename T = double>
+	Payload<T> releaseData() {
+		if constexpr (std::is_same<T, float>::value)
+			return std::move(dataSingle);
+		else
+			return std::move(data);
+	}
+
+	/**
+	* @brief call f(const T* data, size_t n) with the payload, T is double or float
+	*/
+	template <typename F>
+	void visitData(F &&f) const {
+		if(singlePrecision)
+			f(dataSingle.data(), dataSingle.size());
+		else
+			f(data.data(), data.size());
+	}
 
   private:
 	AnalogEvent() {} // for serialization only
 
 	uint32_t id;
 	double max;
-	std::vector<double> data;
+	Payload<double> data;
+	Payload<float> dataSingle; //only used by single precision events
+	bool singlePrecision;
+	uint32_t batchSize;
 
 	ImplementSerializable(SST::BYOD::AnalogEvent);
 };
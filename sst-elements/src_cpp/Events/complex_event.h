@@ -2,45 +2,159 @@
 
 #include <sst/core/event.h>
 
+#include "payload_pool.h"
+#include "payload_serialization.h"
+#include "precision.h"
+
+#include <complex>
+#include <type_traits>
+#include <vector>
+
 namespace SST {
 namespace BYOD {
 
+/**
+* @brief Event carrying a complex (optical) field.
+* @details The field is stored interleaved (re, im, re, im, ...) in a single contiguous buffer,
+* which has the same memory layout as an array of std::complex<double>. Components can therefore
+* adapt the buffer in place (getField()) without splitting it into real and imaginary parts.
+* The buffer is aligned to payloadAlignment (see payload_pool.h) and serialized element by element,
+* so the event can be sent across MPI ranks.
+* Single precision events (see precision.h) carry the field as floats / std::complex<float> instead.
+*/
 class ComplexEvent : public Event {
   public:
 	void serialize_order(SST::Core::Serialization::serializer &ser) override {
 		Event::serialize_order(ser);
 		ser & id;
 		ser & max;
-		ser & dataReal;
-		ser & dataImag;
+		serializePayload(ser, data);
+		serializePayload(ser, dataSingle);
+		ser & singlePrecision;
+		ser & batchSize;
+	}
+
+	/**
+	* @param data interleaved field (re, im, re, im, ...) of batchSize vectors stored one after another
+	* @param batchSize number of vectors carried by the event, the vectors have the ids id ... id + batchSize - 1
+	*/
+	ComplexEvent(uint32_t id, double max, Payload<double> data, uint32_t batchSize = 1) //constructor
+		: Event(),
+		id(id),
+		max(max),
+		data(std::move(data)),
+		singlePrecision(false),
+		batchSize(batchSize)
+
+	{
+		if(this->data.size() % 2 != 0)
+			std::cout << "WARNING: interleaved complex vector has an odd number of entries" << std::endl;
+	}
+
+	/**
+	* @brief single precision field, interleaved like the double precision field
+	*/
+	ComplexEvent(uint32_t id, double max, Payload<float> data, uint32_t batchSize = 1) //constructor
+		: Event(),
+		id(id),
+		max(max),
+		dataSingle(std::move(data)),
+		singlePrecision(true),
+		batchSize(batchSize)
+
+	{
+		if(dataSingle.size() % 2 != 0)
+			std::cout << "WARNING: interleaved complex vector has an odd number of entries" << std::endl;
 	}
 
-	ComplexEvent(uint32_t id, double max, std::vector<double> dataReal, std::vector<double> dataImag) //constructor
+	/**
+	* @brief construct the event from separate real and imaginary parts
+	*/
+	ComplexEvent(uint32_t id, double max, const Payload<double> &dataReal, const Payload<double> &dataImag, uint32_t batchSize = 1) //constructor
 		: Event(),
 		id(id),
-		max(max), 
-		dataReal(dataReal),
-		dataImag(dataImag)
+		max(max),
+		data(PayloadPool<double>::acquire(2 * dataReal.size())),
+		singlePrecision(false),
+		batchSize(batchSize)
 
 	{
 		if(dataReal.size() != dataImag.size())
 			std::cout << "WARNING: real and imaginary vector have different sizes" << std::endl;
+
+		for(size_t i = 0; i < dataReal.size(); i++) {
+			data[2 * i] = dataReal[i];
+			data[2 * i + 1] = i < dataImag.size() ? dataImag[i] : 0.0;
+		}
+	}
+
+	~ComplexEvent() { //the payload is recycled unless it was released
+		PayloadPool<double>::release(std::move(data));
+		PayloadPool<float>::release(std::move(dataSingle));
 	}
 
-	uint32_t getId() { return id; }
-	double getMax() { return max; }
-	std::vector<double> getReal() { return dataReal; }
-	std::vector<double> getImag() { return dataImag; }
+	uint32_t getId() const { return id; }
+	double getMax() const { return max; }
+	uint32_t getBatchSize() const { return batchSize; }
+	bool isSinglePrecision() const { return singlePrecision; }
+
+	/**
+	* @brief number of complex entries (batchSize * vector size)
+	*/
+	size_t getSize() const { return (singlePrecision ? dataSingle.size() : data.size()) / 2; }
+
+	/**
+	* @brief field of the given scalar type, nullptr data if the event has the other precision
+	*/
+	template <typename T = double>
+	const std::complex<T>* getField() const { return reinterpret_cast<const std::complex<T>*>(buffer<T>().data()); }
+	template <typename T = double>
+	std::complex<T>* getField() { return reinterpret_cast<std::complex<T>*>(buffer<T>().data()); }
+
+	/**
+	* @brief move the interleaved field out of the event, e.g. to reuse it as buffer of the output event
+	*/
+	template <typename T = double>
+	Payload<T> releaseField() { return std::move(buffer<T>()); }
+
+	/**
+	* @brief call f(std::complex<T>* field, size_t n) with the field, T is double or float
+	*/
+	template <typename F>
+	void visitField(F &&f) {
+		if(singlePrecision)
+			f(getField<float>(), getSize());
+		else
+			f(getField<double>(), getSize());
+	}
 
   private:
 	ComplexEvent() {} // for serialization only
 
+	template <typename T>
+	const Payload<T>& buffer() const {
+		if constexpr (std::is_same<T, float>::value)
+			return dataSingle;
+		else
+			return data;
+	}
+
+	template <typename T>
+	Payload<T>& buffer() {
+		if constexpr (std::is_same<T, float>::value)
+			return dataSingle;
+		else
+			return data;
+	}
+
 	uint32_t id;
 	double max;
-	std::vector<double> dataReal;
-	std::vector<double> dataImag;
+	Payload<double> data;
+	Payload<float> dataSingle; //only used by single precision events
+	bool singlePrecision;
+	uint32_t batchSize;
 
 	ImplementSerializable(SST::BYOD::ComplexEvent);
 };
 } // namespace BYOD
-} // namespace SST
\ No newline at end of file
+} // namespace SST
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <sst/core/event.h>
+
+namespace SST {
+namespace BYOD {
+
+/**
+* @brief Event returning input queue slots to the upstream component
+* @details a converter announces its queue depth as initial credits during init and returns
+* one credit every time an event leaves its input queue
+*/
+class CreditEvent : public Event {
+  public:
+	void serialize_order(SST::Core::Serialization::serializer &ser) override {
+		Event::serialize_order(ser);
+		ser & credits;
+	}
+
+	CreditEvent(uint32_t credits) //constructor
+		: Event(),
+		credits(credits)
+	{}
+
+	uint32_t getCredits() const { return credits; }
+
+  private:
+	CreditEvent() {} // for serialization only
+
+	uint32_t credits;
+
+	ImplementSerializable(SST::BYOD::CreditEvent);
+};
+} // namespace BYOD
+} // namespace SST
@@ -2,37 +2,175 @@
 
 #include <sst/core/event.h>
 
+#include "payload_pool.h"
+#include "payload_serialization.h"
+#include "../Kernels/digital_kernels.h"
+
+#include <cstdint>
+#include <vector>
+
 namespace SST {
 namespace BYOD {
 
+/**
+* @brief Event carrying digital codes.
+* @details The codes are packed into the narrowest unsigned word that holds the resolution
+* (uint8_t up to 8 bits, uint16_t up to 16 bits, uint32_t up to 32 bits, uint64_t above), only the
+* buffer of that word size is used and serialized. Consumers read the codes either through
+* visitCodes(), which calls a generic callback once with the typed buffer, or unpacked to uint64_t.
+* Codes must fit into the resolution, wider codes saturate to the largest code of the resolution when they are packed.
+*/
 class DigitalEvent : public Event {
   public:
 	void serialize_order(SST::Core::Serialization::serializer &ser) override {
 		Event::serialize_order(ser);
 		ser & id;
 		ser & resolution;
-		ser & data;
+		ser & wordBytes;
+		serializePayload(ser, codes8);
+		serializePayload(ser, codes16);
+		serializePayload(ser, codes32);
+		serializePayload(ser, codes64);
+		ser & batchSize;
 	}
 
-	DigitalEvent(uint32_t id, uint32_t resolution, std::vector<uint64_t> data) //constructor
+	/**
+	* @brief event with count zero codes, the producer writes the codes through visitCodes()
+	* @param count number of codes of all vectors, batchSize vectors are stored one after another
+	* @param batchSize number of vectors carried by the event, the vectors have the ids id ... id + batchSize - 1
+	*/
+	DigitalEvent(uint32_t id, uint32_t resolution, size_t count, uint32_t batchSize = 1) //constructor
 		: Event(),
 		id(id),
-		resolution(resolution), 
-		data(data)
-	{}
+		resolution(resolution),
+		wordBytes(wordBytesForResolution(resolution)),
+		batchSize(batchSize)
+	{
+		visitBuffers([count](auto &codes) { codes = PayloadPool<typename std::decay<decltype(codes)>::type::value_type>::acquire(count); });
+	}
+
+	/**
+	* @brief pack unpacked codes
+	* @param data batchSize vectors stored one after another in a single contiguous buffer
+	* @param batchSize number of vectors carried by the event, the vectors have the ids id ... id + batchSize - 1
+	*/
+	DigitalEvent(uint32_t id, uint32_t resolution, const std::vector<uint64_t> &data, uint32_t batchSize = 1) //constructor
+		: DigitalEvent(id, resolution, data.size(), batchSize)
+	{
+		const uint64_t maxCode = maxCodeForResolution(resolution);
+		visitCodes([&data, maxCode](auto* codes, size_t n) { DigitalKernels::pack(data.data(), codes, n, maxCode); });
+	}
+
+	~DigitalEvent() { //the payload is recycled
+		visitBuffers([](auto &codes) { PayloadPool<typename std::decay<decltype(codes)>::type::value_type>::release(std::move(codes)); });
+	}
 
-	uint32_t getId() { return id; }
-	uint32_t getResolution() { return resolution; }
-	std::vector<uint64_t> getData() { return data; }
+	/**
+	* @brief bytes per packed code for a resolution in bits
+	*/
+	static uint32_t wordBytesForResolution(uint32_t resolution) {
+		return DigitalKernels::wordBytes(resolution);
+	}
+
+	/**
+	* @brief largest code of a resolution in bits, 2^resolution - 1
+	*/
+	static uint64_t maxCodeForResolution(uint32_t resolution) {
+		return DigitalKernels::maxCode(resolution);
+	}
+
+	uint32_t getId() const { return id; }
+	uint32_t getResolution() const { return resolution; }
+	uint32_t getBatchSize() const { return batchSize; }
+	uint32_t getWordBytes() const { return wordBytes; }
+
+	/**
+	* @brief number of codes (batchSize * vector size)
+	*/
+	size_t getSize() const {
+		size_t n = 0;
+		visitCodes([&n](const auto*, size_t count) { n = count; });
+		return n;
+	}
+
+	/**
+	* @brief call f(const T* codes, size_t n) with the packed buffer, T is the word type of the resolution
+	* @details f is usually a generic lambda, so the loop over the codes is compiled for every word type
+	*/
+	template <typename F>
+	void visitCodes(F &&f) const {
+		switch(wordBytes) {
+			case 1: f(codes8.data(), codes8.size()); break;
+			case 2: f(codes16.data(), codes16.size()); break;
+			case 4: f(codes32.data(), codes32.size()); break;
+			default: f(codes64.data(), codes64.size()); break;
+		}
+	}
+
+	/**
+	* @brief call f(T* codes, size_t n) with the packed buffer, e.g. for writing the codes of a new event
+	*/
+	template <typename F>
+	void visitCodes(F &&f) {
+		switch(wordBytes) {
+			case 1: f(codes8.data(), codes8.size()); break;
+			case 2: f(codes16.data(), codes16.size()); break;
+			case 4: f(codes32.data(), codes32.size()); break;
+			default: f(codes64.data(), codes64.size()); break;
+		}
+	}
+
+	/**
+	* @brief code i, widened to uint64_t
+	*/
+	uint64_t getCode(size_t i) const {
+		uint64_t code = 0;
+		visitCodes([&code, i](const auto* codes, size_t) { code = codes[i]; });
+		return code;
+	}
+
+	/**
+	* @brief widen all codes to uint64_t, out must hold getSize() codes
+	*/
+	void unpack(uint64_t* out) const {
+		visitCodes([out](const auto* codes, size_t n) { DigitalKernels::unpack(codes, out, n); });
+	}
+
+	/**
+	* @brief all codes widened to uint64_t
+	*/
+	std::vector<uint64_t> getData() const {
+		std::vector<uint64_t> data(getSize());
+		unpack(data.data());
+		return data;
+	}
 
   private:
 	DigitalEvent() {} // for serialization only
 
+	/**
+	* @brief call f(Payload<T> &) with the buffer of the word size
+	*/
+	template <typename F>
+	void visitBuffers(F &&f) {
+		switch(wordBytes) {
+			case 1: f(codes8); break;
+			case 2: f(codes16); break;
+			case 4: f(codes32); break;
+			default: f(codes64); break;
+		}
+	}
+
 	uint32_t id;
 	uint32_t resolution;
-	std::vector<uint64_t> data;
+	uint32_t wordBytes;
+	Payload<uint8_t> codes8; //only the buffer of wordBytes is used
+	Payload<uint16_t> codes16;
+	Payload<uint32_t> codes32;
+	Payload<uint64_t> codes64;
+	uint32_t batchSize;
 
 	ImplementSerializable(SST::BYOD::DigitalEvent);
 };
 } // namespace BYOD
-} // namespace SST
\ No newline at end of file
+} // namespace SST
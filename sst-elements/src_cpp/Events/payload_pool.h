@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace SST {
+namespace BYOD {
+
+const size_t payloadAlignment = 64; //alignment of the event payloads in bytes, a cache line and the width of an AVX-512 vector
+
+/**
+* @brief allocator of the event payloads, the buffers start at a multiple of payloadAlignment
+* @details malloc only guarantees 16 bytes, so the AVX loads of the kernels could split cache lines
+* depending on where a payload happened to be allocated
+*/
+template <typename T>
+struct AlignedAllocator {
+
+	using value_type = T;
+
+	AlignedAllocator() noexcept {}
+	template <typename U>
+	AlignedAllocator(const AlignedAllocator<U> &) noexcept {}
+
+	T* allocate(size_t n) {
+
+		if(n > std::numeric_limits<size_t>::max() / sizeof(T))
+			throw std::bad_array_new_length();
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(payloadAlignment)));
+	}
+
+	void deallocate(T* p, size_t) noexcept {
+		::operator delete(p, std::align_val_t(payloadAlignment));
+	}
+
+	template <typename U>
+	bool operator==(const AlignedAllocator<U> &) const noexcept { return true; }
+	template <typename U>
+	bool operator!=(const AlignedAllocator<U> &) const noexcept { return false; }
+};
+
+/**
+* @brief contiguous, aligned payload buffer of the events
+*/
+template <typename T>
+using Payload = std::vector<T, AlignedAllocator<T>>;
+
+/**
+* @brief Per-thread free list of event payload buffers.
+* @details AnalogEvent, ComplexEvent and DigitalEvent return their payload to the pool of the deleting thread
+* when they are deleted, receivers that reuse the payload (release*()) pass it on to their output event instead.
+* acquire() hands out the smallest cached buffer that is large enough, so once every hop of a pipeline has seen
+* its largest batch, the payloads circulate without allocations. Each pool keeps at most maxBuffers buffers,
+* surplus buffers (e.g. on a thread that only consumes events) are freed.
+* The event objects themselves come from the per-thread memory pools of SST core (Activity is a MemPoolItem),
+* only the payload vectors inside the events are pooled here. A payload received from another MPI rank
+* is unpacked into a buffer of the pool of the receiving rank (payload_serialization.h).
+*/
+template <typename T>
+class PayloadPool {
+  public:
+	static const size_t maxBuffers = 256;
+
+	/**
+	* @brief buffer of n value-initialized elements, like std::vector<T>(n)
+	*/
+	static Payload<T> acquire(size_t n) {
+
+		std::vector<Payload<T>> &buffers = freeList();
+		size_t best = buffers.size();
+		for(size_t i = 0; i < buffers.size(); i++) //best fit, data vectors and weight sets share the pool
+			if(buffers[i].capacity() >= n && (best == buffers.size() || buffers[i].capacity() < buffers[best].capacity()))
+				best = i;
+
+		Payload<T> buffer;
+		if(best < buffers.size()) {
+			buffer.swap(buffers[best]);
+			buffers[best].swap(buffers.back());
+			buffers.pop_back();
+		}
+		buffer.resize(n);
+		return buffer;
+	}
+
+	/**
+	* @brief return a buffer to the pool of the calling thread, the buffer is empty afterwards
+	*/
+	static void release(Payload<T> &&buffer) {
+
+		std::vector<Payload<T>> &buffers = freeList();
+		if(buffer.capacity() == 0 || buffers.size() >= maxBuffers) {
+			Payload<T>().swap(buffer);
+			return;
+		}
+		buffer.clear();
+		buffers.push_back(std::move(buffer));
+	}
+
+	/**
+	* @brief number of buffers cached by the calling thread
+	*/
+	static size_t cached() { return freeList().size(); }
+
+  private:
+	static std::vector<Payload<T>> &freeList() {
+
+		static thread_local std::vector<Payload<T>> buffers = reserved();
+		return buffers;
+	}
+
+	static std::vector<Payload<T>> reserved() {
+
+		std::vector<Payload<T>> buffers;
+		buffers.reserve(maxBuffers); //the free list itself never grows
+		return buffers;
+	}
+};
+
+/**
+* @brief grow a per-instance workspace of a handler to n elements
+* @details the workspace only grows, so it holds the largest batch after the first one and a warm handler does not allocate
+*/
+template <typename Buffer>
+inline void growWorkspace(Buffer &workspace, size_t n) {
+
+	if(workspace.size() < n)
+		workspace.resize(n);
+}
+} // namespace BYOD
+} // namespace SST
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <sst/core/serialization/serializer.h>
+
+#include "payload_pool.h"
+
+namespace SST {
+namespace BYOD {
+
+/**
+* @brief serialize an event payload as its number of elements followed by the elements
+* @details an unpacked payload is taken from the payload pool of the receiving rank, empty payloads stay unallocated
+*/
+template <typename T>
+inline void serializePayload(SST::Core::Serialization::serializer &ser, Payload<T> &payload) {
+
+	size_t n = payload.size();
+	ser & n;
+	if(ser.mode() == SST::Core::Serialization::serializer::UNPACK)
+		payload = n > 0 ? PayloadPool<T>::acquire(n) : Payload<T>();
+	for(T &value : payload)
+		ser & value;
+}
+} // namespace BYOD
+} // namespace SST
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <string>
+
+namespace SST {
+namespace BYOD {
+
+enum class Precision { Double, Single }; //scalar type of the analog and complex payloads, double or float
+
+/**
+* @brief parse the precision parameter of the analog and optical components
+* @details "double" computes with double and std::complex<double>, "single" with float and std::complex<float>
+*/
+inline Precision parsePrecisionStr(std::string str) {
+
+	std::transform(str.begin(), str.end(), str.begin(),
+				   [](unsigned char c) { return std::tolower(c); });
+
+	if (str == "double") {
+		return Precision::Double;
+	} else if (str == "single") {
+		return Precision::Single;
+	} else {
+		throw std::invalid_argument("Precision not supported. Supported precisions are \"double\" or \"single\" \n");
+	}
+}
+} // namespace BYOD
+} // namespace SST
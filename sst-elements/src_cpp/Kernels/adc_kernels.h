@@ -0,0 +1,44 @@
+#ifndef _adcKernels_H
+#define _adcKernels_H
+
+#include "digital_kernels.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+namespace SST {
+namespace BYOD {
+
+/**
+* @brief Kernels for quantizing the voltages of an array of ADCs.
+*/
+namespace ADCKernels {
+
+/**
+* @brief voltage of one LSB of an ADC with the given input range and resolution
+*/
+inline double quantizationStep(double minVin, double maxVin, uint32_t resolution) {
+	return (maxVin - minVin) / (pow(2, resolution) - 1);
+}
+
+/**
+* @brief quantize n voltages to codes, In is the scalar type of the voltages, T is the packed word type of the resolution
+* @details single precision voltages are widened, so the step is the same for both precisions.
+* Voltages outside of the input range saturate to the codes 0 and maxCode, the code therefore does not depend on the word type
+* @param maxCode largest code of the resolution (DigitalKernels::maxCode())
+*/
+template <typename In, typename T>
+inline void quantize(const In* input, T* output, size_t n, double step, uint64_t maxCode) {
+
+	const double limit = double(maxCode);
+	for(size_t i = 0; i < n; i++) {
+		const double level = double(input[i]) / step;
+		output[i] = T(!(level > 0.0) ? 0 : level >= limit ? maxCode : static_cast<uint64_t>(level)); //NaN maps to 0
+	}
+}
+} // namespace ADCKernels
+} // namespace BYOD
+} // namespace SST
+
+#endif
@@ -0,0 +1,104 @@
+// Copyright (2025) Hewlett Packard Enterprise Development LP
+// 
+// Licensed under the MIT License (the "License")
+//
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "allocation_counter.h"
+
+#include <new>
+
+// Replacement of the global operator new for --enable-allocation-count builds, the library is linked with
+// -Bsymbolic-functions so the allocations of the element bind to these definitions and not to libstdc++.
+// Memory is taken from malloc (aligned_alloc for the aligned event payloads) like the default operator new,
+// so it can be freed by either side.
+
+namespace {
+thread_local uint64_t allocations = 0;
+thread_local uint64_t allocatedBytes = 0;
+}
+
+uint64_t SST::BYOD::AllocationCounter::count() {
+	return allocations;
+}
+
+uint64_t SST::BYOD::AllocationCounter::bytes() {
+	return allocatedBytes;
+}
+
+void* operator new(std::size_t n) {
+
+	allocations++;
+	allocatedBytes += n;
+	if(void* p = std::malloc(n ? n : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t n) {
+	return operator new(n);
+}
+
+void* operator new(std::size_t n, const std::nothrow_t &) noexcept {
+
+	allocations++;
+	allocatedBytes += n;
+	return std::malloc(n ? n : 1);
+}
+
+void* operator new[](std::size_t n, const std::nothrow_t &tag) noexcept {
+	return operator new(n, tag);
+}
+
+void* operator new(std::size_t n, std::align_val_t alignment) {
+
+	allocations++;
+	allocatedBytes += n;
+	const std::size_t a = std::size_t(alignment);
+	if(void* p = std::aligned_alloc(a, n ? (n + a - 1) / a * a : a)) //the size must be a multiple of the alignment
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t n, std::align_val_t alignment) {
+	return operator new(n, alignment);
+}
+
+void* operator new(std::size_t n, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+
+	try {
+		return operator new(n, alignment);
+	} catch(const std::bad_alloc &) {
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t n, std::align_val_t alignment, const std::nothrow_t &tag) noexcept {
+	return operator new(n, alignment, tag);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
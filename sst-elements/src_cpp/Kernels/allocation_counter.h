@@ -0,0 +1,81 @@
+#ifndef _allocationCounter_H
+#define _allocationCounter_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace SST {
+namespace BYOD {
+
+/**
+* @brief Heap allocation counter for checking that the event handlers do not allocate once they are warm.
+* @details Only active when the element is configured with --enable-allocation-count, which defines
+* BYOD_COUNT_ALLOCATIONS and replaces the global operator new of the element library (Kernels/allocation_counter.cc).
+* Without the flag count() is always 0 and the checks compile to nothing.
+* The standalone benchmark (Benchmarks/byod_bench.cc) is always built with the counter.
+*/
+namespace AllocationCounter {
+
+#ifdef BYOD_COUNT_ALLOCATIONS
+/**
+* @brief number of heap allocations of the calling thread so far
+*/
+uint64_t count();
+
+/**
+* @brief number of bytes requested by the heap allocations of the calling thread so far
+*/
+uint64_t bytes();
+#else
+inline uint64_t count() { return 0; }
+inline uint64_t bytes() { return 0; }
+#endif
+
+} // namespace AllocationCounter
+
+/**
+* @brief allocation check of one event handler
+* @details the first warmupEvents events may allocate (the workspaces grow to the largest batch),
+* every later event that allocates aborts the simulation
+*/
+struct AllocationCheck {
+
+	AllocationCheck(const char* handler, uint64_t warmupEvents = 16) : handler(handler), warmupEvents(warmupEvents) {}
+
+	void record(uint64_t allocations) {
+
+		if(++events > warmupEvents && allocations > 0) {
+			std::fprintf(stderr, "%s: %llu heap allocations in event %llu, the handler must not allocate once it is warm\n",
+				handler, (unsigned long long)allocations, (unsigned long long)events);
+			std::abort();
+		}
+	}
+
+	const char* handler;
+	uint64_t warmupEvents;
+	uint64_t events = 0;
+};
+
+/**
+* @brief counts the heap allocations between construction and destruction for an AllocationCheck
+*/
+class AllocationScope {
+  public:
+	AllocationScope(AllocationCheck &check) : check(check), start(AllocationCounter::count()) {}
+
+#ifdef BYOD_COUNT_ALLOCATIONS
+	~AllocationScope() { check.record(AllocationCounter::count() - start); }
+#endif
+
+	AllocationScope(const AllocationScope &) = delete;
+	AllocationScope &operator=(const AllocationScope &) = delete;
+
+  private:
+	AllocationCheck &check;
+	uint64_t start;
+};
+} // namespace BYOD
+} // namespace SST
+
+#endif
@@ -0,0 +1,68 @@
+// Copyright (2025) Hewlett Packard Enterprise Development LP
+// 
+// Licensed under the MIT License (the "License")
+//
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "clements_kernels.h"
+
+#include <vector>
+
+// C interface of the Clements kernels, loaded with ctypes by ClementsMesh in utils/byod_components.py.
+// The library does not depend on SST, so configurations can be generated without starting a simulation.
+
+extern "C" {
+
+/**
+* @brief decompose a unitary matrix into the size * size phases of a Clements mesh (see ClementsKernels::decompose)
+* @param unitary row-major size x size matrix, interleaved real and imaginary parts (numpy complex128)
+* @param phases size * size phases in the order of clements::reconstructUnitaryMatrix (output)
+* @param tolerance max. deviation of U * U^H from the identity
+* @return 0 on success, -1 if the matrix is not unitary within the tolerance
+*/
+int byod_clements_decompose(const double* unitary, uint32_t size, double* phases, double tolerance) {
+
+	const std::complex<double>* matrix = reinterpret_cast<const std::complex<double>*>(unitary);
+
+	for(uint32_t r = 0; r < size; r++) {
+		for(uint32_t c = 0; c < size; c++) {
+
+			std::complex<double> sum = 0.0;
+			for(uint32_t k = 0; k < size; k++)
+				sum += matrix[size_t(r) * size + k] * std::conj(matrix[size_t(c) * size + k]);
+			if(std::abs(sum - (r == c ? 1.0 : 0.0)) > tolerance)
+				return -1;
+		}
+	}
+
+	SST::BYOD::ClementsKernels::decompose(matrix, size, phases);
+	return 0;
+}
+
+/**
+* @brief transfer matrix of a Clements mesh, identical to clements::reconstructUnitaryMatrix
+* @param phases size * size phases of the mesh
+* @param matrix row-major size x size matrix, interleaved real and imaginary parts (output)
+*/
+void byod_clements_reconstruct(const double* phases, uint32_t size, double* matrix) {
+
+	SST::BYOD::ClementsKernels::reconstruct(reinterpret_cast<std::complex<double>*>(matrix), size, phases);
+}
+}
@@ -0,0 +1,759 @@
+#ifndef _clementsKernels_H
+#define _clementsKernels_H
+
+#include <array>
+#include <cstdint>
+#include <complex>
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace SST {
+namespace BYOD {
+
+enum PropagationMode { Matrix, Layered }; //enum for representing how data is propagated through a mesh
+
+/**
+* @brief parse the propagationMode parameter of the Clements meshes
+* @details "matrix" multiplies the data with a dense transfer matrix that is rebuilt on every weight update,
+* "layered" propagates the data through the MZI columns directly without building the matrix
+*/
+inline PropagationMode parsePropagationModeStr(std::string str) {
+
+	std::transform(str.begin(), str.end(), str.begin(),
+				   [](unsigned char c) { return std::tolower(c); });
+
+	if (str == "matrix") {
+		return PropagationMode::Matrix;
+	} else if (str == "layered") {
+		return PropagationMode::Layered;
+	} else {
+		throw std::invalid_argument("Propagation mode not supported. Supported modes are \"matrix\" or \"layered\" \n");
+	}
+}
+
+/**
+* @brief Structured kernels for propagating optical fields through a Clements mesh.
+* @details A Clements mesh of size N consists of N columns. Each column holds two
+* half-layers (a phase shifter on the upper arm of every MZI followed by a 50:50
+* directional coupler) acting on the mode pairs (start, start + 1), (start + 2, start + 3), ...
+* with start = column % 2. The mesh is terminated by a column of N output phase shifters.
+* The phases are stored in the order they are applied, identical to the order
+* produced by ClementsMesh.flatten_phase in utils/byod_components.py.
+* Instead of building dense N x N layer matrices, every half-layer is applied as
+* a set of 2x2 row rotations, so a full reconstruction costs O(N^3) and a
+* vector propagation O(N^2).
+* The field kernels are templated on the scalar type of the field (double or float, see Events/precision.h),
+* the phases are always double and the rotation coefficients are rounded to the field type.
+* All fields are stored row-major with one row per optical mode and "cols"
+* independent columns (cols = 1 for a single vector, cols = N for a matrix).
+* The columns of a field never mix, so a field can be processed in blocks of columns
+* by passing the row stride of the full field as "stride" (0 if the rows are contiguous).
+*/
+namespace ClementsKernels {
+
+/**
+* @brief number of MZIs in a half-layer starting at mode "start"
+*/
+inline uint32_t pairsInLayer(uint32_t size, uint32_t start) {
+	return (size - start) / 2;
+}
+
+/**
+* @brief number of phases needed to program a mesh of the given size
+*/
+inline uint32_t numPhases(uint32_t size) {
+	return size * size;
+}
+
+/**
+* @brief index of the first phase of a column
+* @details columns alternate between starting at mode 0 and mode 1, every column holds two phases per MZI.
+* columnOffset(size, size) is the index of the first output phase
+*/
+inline uint32_t columnOffset(uint32_t size, uint32_t column) {
+	return 2 * (((column + 1) / 2) * pairsInLayer(size, 0) + (column / 2) * pairsInLayer(size, 1));
+}
+
+/**
+* @brief column a phase belongs to, size for the output phases
+*/
+inline uint32_t columnOfPhase(uint32_t size, uint32_t index) {
+
+	uint32_t column = 0;
+	while(column < size && columnOffset(size, column + 1) <= index)
+		column++;
+	return column;
+}
+
+/**
+* @brief one MZI half-layer on the interleaved entries a = (re, im) and b = (re, im) of a pair of modes
+* @param pr, pi e^{j phi} of the phase shifter
+* @param s 1 / sqrt(2) of the directional coupler
+*/
+template <typename T>
+inline void rotatePair(T* a, T* b, T pr, T pi, T s) {
+
+	// x = e^{j phi} * a, y = b
+	const T xr = pr * a[0] - pi * a[1];
+	const T xi = pr * a[1] + pi * a[0];
+	const T yr = b[0];
+	const T yi = b[1];
+
+	a[0] = s * (xr - yi);
+	a[1] = s * (xi + yr);
+	b[0] = s * (yr - xi);
+	b[1] = s * (yi + xr);
+}
+
+/**
+* @brief apply one half-layer (phase shifters + directional couplers) from the left
+* @details for every pair (i, i + 1) the rows are transformed as
+* r_i <- (e^{j phi} r_i + j r_{i+1}) / sqrt(2)
+* r_{i+1} <- (j e^{j phi} r_i + r_{i+1}) / sqrt(2)
+* @param field row-major field with size rows and cols columns, modified in place
+* @param phases phases of the half-layer, one per pair
+* @param stride row stride of the field in elements, 0 for cols
+*/
+template <typename T>
+inline void applyHalfLayer(std::complex<T>* field, uint32_t size, uint32_t cols, uint32_t start, const double* phases, size_t stride = 0) {
+
+	const T s = T(1.0 / std::sqrt(2.0));
+	const size_t ld = stride ? stride : cols;
+	T* data = reinterpret_cast<T*>(field);
+
+	for(uint32_t i = start, k = 0; i + 1 < size; i += 2, k++) {
+
+		const T pr = T(std::cos(phases[k]));
+		const T pi = T(std::sin(phases[k]));
+		T* a = data + 2 * size_t(i) * ld;
+		T* b = a + 2 * ld;
+
+		for(uint32_t c = 0; c < cols; c++)
+			rotatePair(a + 2 * c, b + 2 * c, pr, pi, s);
+	}
+}
+
+/**
+* @brief multiply the interleaved entry a = (re, im) with e^{j phi} = pr + j pi
+*/
+template <typename T>
+inline void rotate(T* a, T pr, T pi) {
+
+	const T xr = a[0];
+	const T xi = a[1];
+	a[0] = pr * xr - pi * xi;
+	a[1] = pr * xi + pi * xr;
+}
+
+/**
+* @brief multiply every row of the field with e^{j phase} of the corresponding output phase shifter
+*/
+template <typename T>
+inline void applyOutputPhases(std::complex<T>* field, uint32_t size, uint32_t cols, const double* phases, size_t stride = 0) {
+
+	const size_t ld = stride ? stride : cols;
+	T* data = reinterpret_cast<T*>(field);
+
+	for(uint32_t i = 0; i < size; i++) {
+
+		const T pr = T(std::cos(phases[i]));
+		const T pi = T(std::sin(phases[i]));
+		T* a = data + 2 * size_t(i) * ld;
+
+		for(uint32_t c = 0; c < cols; c++)
+			rotate(a + 2 * c, pr, pi);
+	}
+}
+
+/**
+* @brief propagate a field through the MZI columns first ... last - 1 of the mesh (without output phases)
+* @param field row-major field with size rows and cols columns, modified in place
+* @param phases size * size phases of the mesh
+*/
+template <typename T>
+inline void propagateColumns(std::complex<T>* field, uint32_t size, uint32_t cols, const double* phases, uint32_t first, uint32_t last, size_t stride = 0) {
+
+	uint32_t index = columnOffset(size, first);
+
+	for(uint32_t i = first; i < last; i++) {
+
+		const uint32_t start = i % 2;
+		const uint32_t pairs = pairsInLayer(size, start);
+
+		applyHalfLayer(field, size, cols, start, phases + index, stride);
+		index += pairs;
+		applyHalfLayer(field, size, cols, start, phases + index, stride);
+		index += pairs;
+	}
+}
+
+/**
+* @brief propagate a field through the whole mesh (field <- T * field)
+* @param field row-major field with size rows and cols columns, modified in place
+* @param phases size * size phases of the mesh
+*/
+template <typename T>
+inline void propagate(std::complex<T>* field, uint32_t size, uint32_t cols, const double* phases, size_t stride = 0) {
+
+	propagateColumns(field, size, cols, phases, 0, size, stride);
+	applyOutputPhases(field, size, cols, phases + columnOffset(size, size), stride);
+}
+
+/**
+* @brief transpose a row-major rows x cols field into out (cols x rows), e.g. between one row per vector of a batch
+* and one row per optical mode
+*/
+template <typename T>
+inline void transpose(const std::complex<T>* field, std::complex<T>* out, uint32_t rows, uint32_t cols) {
+
+	for(uint32_t r = 0; r < rows; r++)
+		for(uint32_t c = 0; c < cols; c++)
+			out[size_t(c) * rows + r] = field[size_t(r) * cols + c];
+}
+
+/**
+* @brief e^{j phi} of every phase of a mesh, interleaved (cos, sin), so the propagation does not evaluate cos and sin per event
+* @param rotations 2 * size * size entries (output)
+*/
+template <typename T>
+inline void phaseRotations(const double* phases, uint32_t size, T* rotations) {
+
+	for(uint32_t k = 0; k < numPhases(size); k++) {
+		rotations[2 * k] = T(std::cos(phases[k]));
+		rotations[2 * k + 1] = T(std::sin(phases[k]));
+	}
+}
+
+/**
+* @brief propagate a field through the whole mesh (field <- T * field) with the rotations of phaseRotations()
+* @details computes the same rotations as propagate(), the result is identical
+*/
+template <typename T>
+inline void propagateRotations(std::complex<T>* field, uint32_t size, uint32_t cols, const T* rotations, size_t stride = 0) {
+
+	const T s = T(1.0 / std::sqrt(2.0));
+	const size_t ld = stride ? stride : cols;
+	T* data = reinterpret_cast<T*>(field);
+	uint32_t index = 0;
+
+	for(uint32_t layer = 0; layer < 2 * size; layer++) { //two half-layers per MZI column
+
+		for(uint32_t i = (layer / 2) % 2; i + 1 < size; i += 2, index++) {
+
+			T* a = data + 2 * size_t(i) * ld;
+			T* b = a + 2 * ld;
+			for(uint32_t c = 0; c < cols; c++)
+				rotatePair(a + 2 * c, b + 2 * c, rotations[2 * index], rotations[2 * index + 1], s);
+		}
+	}
+
+	for(uint32_t i = 0; i < size; i++, index++) { //output phases
+
+		T* a = data + 2 * size_t(i) * ld;
+		for(uint32_t c = 0; c < cols; c++)
+			rotate(a + 2 * c, rotations[2 * index], rotations[2 * index + 1]);
+	}
+}
+
+/**
+* @brief propagate a batch of vectors through a mesh whose size N is known at compile time, for the common small meshes (see selectKernels)
+* @details unlike the generic kernels the field has one row per vector (the layout of a batched event), so no transpose is needed.
+* Every vector is loaded into a fixed-size array, passed through all MZI columns and the output phases with unrolled loops
+* and stored back. The rotations are the same as in propagateRotations(), so the result is identical to the generic kernels
+* @param field row-major field with vectors rows and N columns, modified in place
+* @param rotations phase rotations of the mesh (phaseRotations())
+*/
+template <uint32_t N, typename T>
+inline void propagateVectorsFixed(std::complex<T>* field, uint32_t vectors, const T* rotations) {
+
+	const T s = T(1.0 / std::sqrt(2.0));
+	T* data = reinterpret_cast<T*>(field);
+
+	for(uint32_t v = 0; v < vectors; v++) {
+
+		T* vec = data + 2 * size_t(v) * N;
+		std::array<T, 2 * N> x;
+		std::copy(vec, vec + 2 * N, x.begin());
+
+		uint32_t index = 0;
+		#pragma GCC unroll 2
+		for(uint32_t layer = 0; layer < 2 * N; layer++) { //two half-layers per MZI column, unrolling one column keeps the code small for N = 16
+			#pragma GCC unroll 8
+			for(uint32_t i = (layer / 2) % 2; i + 1 < N; i += 2, index++)
+				rotatePair(&x[2 * i], &x[2 * i + 2], rotations[2 * index], rotations[2 * index + 1], s);
+		}
+
+		#pragma GCC unroll 16
+		for(uint32_t i = 0; i < N; i++, index++) //output phases
+			rotate(&x[2 * i], rotations[2 * index], rotations[2 * index + 1]);
+
+		std::copy(x.begin(), x.end(), vec);
+	}
+}
+
+/**
+* @brief out <- field * matrix^T for a field with rows rows of N entries, e.g. a batch with one row per vector
+* @details replaces the BLAS GEMM for the small meshes, whose call overhead exceeds the arithmetic
+*/
+template <uint32_t N, typename T>
+inline void multiplyFixed(const std::complex<T>* field, const std::complex<T>* matrix, std::complex<T>* out, uint32_t rows) {
+
+	const T* m = reinterpret_cast<const T*>(matrix);
+
+	for(uint32_t r = 0; r < rows; r++) {
+
+		const T* x = reinterpret_cast<const T*>(field + size_t(r) * N);
+		T* y = reinterpret_cast<T*>(out + size_t(r) * N);
+
+		#pragma GCC unroll 16
+		for(uint32_t i = 0; i < N; i++) {
+			T sr = T(0.0), si = T(0.0);
+			#pragma GCC unroll 16
+			for(uint32_t j = 0; j < N; j++) {
+				sr += m[2 * (i * N + j)] * x[2 * j] - m[2 * (i * N + j) + 1] * x[2 * j + 1];
+				si += m[2 * (i * N + j)] * x[2 * j + 1] + m[2 * (i * N + j) + 1] * x[2 * j];
+			}
+			y[2 * i] = sr;
+			y[2 * i + 1] = si;
+		}
+	}
+}
+
+template <typename T>
+using PropagateVectorsFunction = void (*)(std::complex<T>* field, uint32_t vectors, const T* rotations);
+
+template <typename T>
+using MultiplyFunction = void (*)(const std::complex<T>* field, const std::complex<T>* matrix, std::complex<T>* out, uint32_t rows);
+
+/**
+* @brief fixed-size kernels of a mesh, selected once from the mesh size when the mesh is constructed
+* @details nullptr if there is no fixed-size kernel for the size, the mesh then uses propagateRotations() and BLAS
+*/
+template <typename T>
+struct MeshKernels {
+	PropagateVectorsFunction<T> propagateVectors;
+	MultiplyFunction<T> multiply;
+};
+
+/**
+* @brief fixed-size kernels for meshes of size 4, 8 and 16
+*/
+template <typename T>
+inline MeshKernels<T> selectKernels(uint32_t size) {
+
+	switch(size) {
+		case 4: return MeshKernels<T>{&propagateVectorsFixed<4, T>, &multiplyFixed<4, T>};
+		case 8: return MeshKernels<T>{&propagateVectorsFixed<8, T>, &multiplyFixed<8, T>};
+		case 16: return MeshKernels<T>{&propagateVectorsFixed<16, T>, &multiplyFixed<16, T>};
+		default: return MeshKernels<T>{nullptr, nullptr};
+	}
+}
+
+/**
+* @brief layered propagation of a batch with one row per vector, the layout of a batched event
+* @details uses the fixed-size kernel of the mesh if there is one. The generic kernels expect one row per optical mode,
+* so a batch of more than one vector is transposed into work and back
+* @param work workspace of at least vectors * size entries
+* @param rotations phase rotations of the mesh (phaseRotations())
+*/
+template <typename T>
+inline void propagateBatch(const MeshKernels<T> &kernels, std::complex<T>* field, std::complex<T>* work, uint32_t size, uint32_t vectors, const T* rotations) {
+
+	if(kernels.propagateVectors)
+		kernels.propagateVectors(field, vectors, rotations);
+	else if(vectors == 1) //a single vector already has one row per optical mode
+		propagateRotations(field, size, 1, rotations);
+	else {
+		transpose(field, work, vectors, size);
+		propagateRotations(work, size, vectors, rotations);
+		transpose(work, field, size, vectors);
+	}
+}
+
+/**
+* @brief layered propagation of a batch with one row per vector through an SVD mesh, y = U * S * V * x
+* @param work workspace of at least vectors * size entries
+* @param phasesS size singular values (amplitudes) of S
+*/
+template <typename T>
+inline void propagateBatchSVD(const MeshKernels<T> &kernels, std::complex<T>* field, std::complex<T>* work, uint32_t size, uint32_t vectors,
+	const T* rotationsU, const double* phasesS, const T* rotationsV) {
+
+	if(kernels.propagateVectors) {
+
+		kernels.propagateVectors(field, vectors, rotationsV);
+		for(uint32_t b = 0; b < vectors; b++)
+			for(uint32_t i = 0; i < size; i++)
+				field[size_t(b) * size + i] *= T(phasesS[i]);
+		kernels.propagateVectors(field, vectors, rotationsU);
+	}
+	else if(vectors == 1) { //a single vector already has one row per optical mode
+
+		propagateRotations(field, size, 1, rotationsV);
+		for(uint32_t i = 0; i < size; i++)
+			field[i] *= T(phasesS[i]);
+		propagateRotations(field, size, 1, rotationsU);
+	}
+	else {
+
+		transpose(field, work, vectors, size);
+		propagateRotations(work, size, vectors, rotationsV);
+		for(uint32_t i = 0; i < size; i++)
+			for(uint32_t b = 0; b < vectors; b++)
+				work[size_t(i) * vectors + b] *= T(phasesS[i]);
+		propagateRotations(work, size, vectors, rotationsU);
+		transpose(work, field, size, vectors);
+	}
+}
+
+/**
+* @brief move a product computed in the workspace to the field buffer of the output event
+* @details if the field buffer is at least as large as the workspace the two are swapped and the input buffer becomes
+* the next workspace. The product of a smaller batch is copied, so the workspace keeps the capacity of the largest batch
+*/
+template <typename Buffer>
+inline void takeProduct(Buffer &buffer, Buffer &workspace) {
+
+	if(buffer.capacity() >= workspace.capacity()) {
+
+		buffer.swap(workspace);
+		buffer.resize(workspace.size());
+	}
+	else
+		std::copy(workspace.begin(), workspace.begin() + buffer.size(), buffer.begin());
+}
+
+/**
+* @brief columns per block when a field with cols columns is split among numThreads threads
+*/
+inline uint32_t blockColumns(uint32_t cols, uint32_t numThreads) {
+	return numThreads > 1 ? (cols + numThreads - 1) / numThreads : cols;
+}
+
+/**
+* @brief reconstruct the dense transfer matrix T of the mesh
+* @details with numThreads > 1 the columns of T are split into one block per OpenMP thread,
+* the blocks are independent so no synchronization is needed between the MZI columns
+* @param matrix row-major size x size output matrix
+* @param phases size * size phases of the mesh
+*/
+template <typename T>
+inline void reconstruct(std::complex<T>* matrix, uint32_t size, const double* phases, uint32_t numThreads = 1) {
+
+	for(size_t i = 0; i < size_t(size) * size; i++)
+		matrix[i] = T(0.0);
+	for(uint32_t i = 0; i < size; i++)
+		matrix[size_t(i) * size + i] = T(1.0);
+
+	const uint32_t block = blockColumns(size, numThreads);
+
+	#pragma omp parallel for num_threads(numThreads) schedule(static) if(numThreads > 1)
+	for(uint32_t c = 0; c < size; c += block)
+		propagate(matrix + c, size, std::min(block, size - c), phases, size);
+}
+
+/**
+* @brief number of stages of an SVD mesh U * S * V
+* @details a field passes the stages in the order V columns (0 ... size - 1), V output phases (size), S (size + 1),
+* U columns (size + 2 ... 2 * size + 1) and U output phases (2 * size + 2)
+*/
+inline uint32_t numSVDStages(uint32_t size) {
+	return 2 * size + 3;
+}
+
+/**
+* @brief propagate a field through the stages first ... last - 1 of an SVD mesh
+* @param phasesS size singular values (amplitudes) of S
+*/
+template <typename T>
+inline void propagateSVDStages(std::complex<T>* field, uint32_t size, uint32_t cols, const double* phasesU, const double* phasesS, const double* phasesV, uint32_t first, uint32_t last, size_t stride = 0) {
+
+	const size_t ld = stride ? stride : cols;
+
+	for(uint32_t stage = first; stage < last; ) {
+
+		if(stage < size) { //consecutive MZI columns of V are applied in one call
+			const uint32_t end = std::min(last, size);
+			propagateColumns(field, size, cols, phasesV, stage, end, ld);
+			stage = end;
+		}
+		else if(stage == size) {
+			applyOutputPhases(field, size, cols, phasesV + columnOffset(size, size), ld);
+			stage++;
+		}
+		else if(stage == size + 1) {
+			for(uint32_t i = 0; i < size; i++)
+				for(uint32_t c = 0; c < cols; c++)
+					field[size_t(i) * ld + c] *= T(phasesS[i]);
+			stage++;
+		}
+		else if(stage < 2 * size + 2) { //consecutive MZI columns of U are applied in one call
+			const uint32_t end = std::min(last, 2 * size + 2);
+			propagateColumns(field, size, cols, phasesU, stage - size - 2, end - size - 2, ld);
+			stage = end;
+		}
+		else {
+			applyOutputPhases(field, size, cols, phasesU + columnOffset(size, size), ld);
+			stage++;
+		}
+	}
+}
+
+/**
+* @brief reconstruct the full matrix U * S * V of an SVD mesh, starting from the product of the first stages
+* @details the checkpoint holds the product of the stages 0 ... fromStage - 1 and is advanced to the stages
+* 0 ... firstStage - 1, the full matrix is the checkpoint propagated through the remaining stages.
+* Without checkpoint (nullptr) the full matrix is rebuilt from the identity.
+* The columns are split into one block per OpenMP thread like in reconstruct()
+* @param full row-major size x size output matrix
+* @param checkpoint row-major size x size matrix or nullptr
+*/
+template <typename T>
+inline void reconstructSVD(std::complex<T>* full, std::complex<T>* checkpoint, uint32_t size, const double* phasesU, const double* phasesS, const double* phasesV,
+						   uint32_t fromStage, uint32_t firstStage, uint32_t numThreads = 1) {
+
+	const uint32_t block = blockColumns(size, numThreads);
+
+	#pragma omp parallel for num_threads(numThreads) schedule(static) if(numThreads > 1)
+	for(uint32_t c = 0; c < size; c += block) {
+
+		const uint32_t cols = std::min(block, size - c);
+		if(checkpoint) {
+
+			propagateSVDStages(checkpoint + c, size, cols, phasesU, phasesS, phasesV, fromStage, firstStage, size);
+			for(uint32_t i = 0; i < size; i++)
+				std::copy(checkpoint + size_t(i) * size + c, checkpoint + size_t(i) * size + c + cols, full + size_t(i) * size + c);
+		}
+		else //restart the columns of the block from the identity
+			for(uint32_t i = 0; i < size; i++)
+				for(uint32_t j = c; j < c + cols; j++)
+					full[size_t(i) * size + j] = T((i == j) ? 1.0 : 0.0);
+		propagateSVDStages(full + c, size, cols, phasesU, phasesS, phasesV, firstStage, numSVDStages(size), size);
+	}
+}
+
+/**
+* @brief apply one half-layer from the right (rows of the matrix are transformed by the transposed half-layer)
+* @details for every row and pair (i, i + 1) the columns are transformed as
+* x_i <- e^{j phi} (x_i + j x_{i+1}) / sqrt(2)
+* x_{i+1} <- (j x_i + x_{i+1}) / sqrt(2)
+*/
+inline void applyHalfLayerRight(std::complex<double>* matrix, uint32_t rows, uint32_t size, uint32_t start, const double* phases) {
+
+	const double s = 1.0 / std::sqrt(2.0);
+	double* data = reinterpret_cast<double*>(matrix);
+
+	for(uint32_t i = start, k = 0; i + 1 < size; i += 2, k++) {
+
+		const double pr = s * std::cos(phases[k]);
+		const double pi = s * std::sin(phases[k]);
+
+		for(uint32_t r = 0; r < rows; r++) {
+
+			double* a = data + 2 * (size_t(r) * size + i);
+			const double ar = a[0], ai = a[1], br = a[2], bi = a[3];
+			// u = a + j b, v = j a + b
+			const double ur = ar - bi, ui = ai + br;
+			a[0] = pr * ur - pi * ui;
+			a[1] = pr * ui + pi * ur;
+			a[2] = s * (br - ai);
+			a[3] = s * (bi + ar);
+		}
+	}
+}
+
+/**
+* @brief multiply a matrix with the transfer matrix of the mesh from the right (matrix <- matrix * T)
+* @param matrix row-major matrix with rows rows and size columns, modified in place
+* @param phases size * size phases of the mesh
+*/
+inline void propagateRight(std::complex<double>* matrix, uint32_t rows, uint32_t size, const double* phases) {
+
+	// the output phases are applied last to a field and therefore first from the right
+	uint32_t index = numPhases(size) - size;
+	double* data = reinterpret_cast<double*>(matrix);
+
+	for(uint32_t r = 0; r < rows; r++) {
+		for(uint32_t i = 0; i < size; i++) {
+			double* a = data + 2 * (size_t(r) * size + i);
+			const double pr = std::cos(phases[index + i]);
+			const double pi = std::sin(phases[index + i]);
+			const double xr = a[0], xi = a[1];
+			a[0] = pr * xr - pi * xi;
+			a[1] = pr * xi + pi * xr;
+		}
+	}
+
+	for(uint32_t i = size; i-- > 0; ) {
+
+		const uint32_t start = i % 2;
+		const uint32_t pairs = pairsInLayer(size, start);
+
+		index -= pairs;
+		applyHalfLayerRight(matrix, rows, size, start, phases + index);
+		index -= pairs;
+		applyHalfLayerRight(matrix, rows, size, start, phases + index);
+	}
+}
+
+/**
+* @brief MZI of the mesh acting on the modes (m, m + 1), both half-layers combined
+* @details T = j e^{j theta} [[e^{j phi} sin(theta), cos(theta)], [e^{j phi} cos(theta), -sin(theta)]]
+* with phi the phase of the first half-layer and 2 theta the phase of the second one (see ClementsMesh.U2MZI)
+*/
+struct MZI {
+
+	std::complex<double> t00, t01, t10, t11;
+
+	MZI(double phi, double theta) {
+
+		const std::complex<double> j(0.0, 1.0);
+		const std::complex<double> common = j * std::polar(1.0, theta);
+		const std::complex<double> shift = std::polar(1.0, phi);
+		t00 = common * shift * std::sin(theta);
+		t01 = common * std::cos(theta);
+		t10 = common * shift * std::cos(theta);
+		t11 = -common * std::sin(theta);
+	}
+
+	/**
+	* @brief matrix <- T * matrix on the rows (m, m + 1), conjugate = true applies T^H instead
+	*/
+	void applyLeft(std::complex<double>* matrix, uint32_t size, uint32_t m, bool conjugate) const {
+
+		const std::complex<double> a00 = conjugate ? std::conj(t00) : t00, a01 = conjugate ? std::conj(t10) : t01;
+		const std::complex<double> a10 = conjugate ? std::conj(t01) : t10, a11 = conjugate ? std::conj(t11) : t11;
+		std::complex<double>* r1 = matrix + size_t(m) * size;
+		std::complex<double>* r2 = r1 + size;
+
+		for(uint32_t c = 0; c < size; c++) {
+			const std::complex<double> x = r1[c], y = r2[c];
+			r1[c] = a00 * x + a01 * y;
+			r2[c] = a10 * x + a11 * y;
+		}
+	}
+
+	/**
+	* @brief matrix <- matrix * T^H on the columns (m, m + 1)
+	*/
+	void applyRightInverse(std::complex<double>* matrix, uint32_t size, uint32_t m) const {
+
+		for(uint32_t r = 0; r < size; r++) {
+			std::complex<double>* row = matrix + size_t(r) * size + m;
+			const std::complex<double> x = row[0], y = row[1];
+			row[0] = x * std::conj(t00) + y * std::conj(t01);
+			row[1] = x * std::conj(t10) + y * std::conj(t11);
+		}
+	}
+};
+
+/**
+* @brief angles of the MZI whose inverse, applied from the right, nulls a * T^H_00 + b * T^H_10 (a and b are the entries of a row in the columns m, m + 1)
+* @details a e^{-j phi} sin(theta) + b cos(theta) = 0 is solved in closed form, theta is in [0, pi/2]
+*/
+inline MZI nullFromRight(std::complex<double> a, std::complex<double> b, double &phi, double &theta) {
+
+	theta = std::atan2(std::abs(b), std::abs(a));
+	phi = std::arg(a) - std::arg(b) + M_PI;
+	return MZI(phi, theta);
+}
+
+/**
+* @brief angles of the MZI that, applied from the left, nulls T_10 * a + T_11 * b (a and b are the entries of a column in the rows m, m + 1)
+* @details e^{j phi} cos(theta) a - sin(theta) b = 0 is solved in closed form, theta is in [0, pi/2]
+*/
+inline MZI nullFromLeft(std::complex<double> a, std::complex<double> b, double &phi, double &theta) {
+
+	theta = std::atan2(std::abs(a), std::abs(b));
+	phi = std::arg(b) - std::arg(a);
+	return MZI(phi, theta);
+}
+
+/**
+* @brief wrap a phase to [0, 2 pi)
+*/
+inline double wrapPhase(double phase) {
+
+	phase = std::fmod(phase, 2.0 * M_PI);
+	return phase < 0.0 ? phase + 2.0 * M_PI : phase;
+}
+
+/**
+* @brief analytic Clements decomposition of a unitary matrix into the phases of the mesh, the inverse of reconstruct
+* @details the entries below the anti-diagonals are nulled alternately by MZIs applied from the right and from the left,
+* with the angles of every MZI given in closed form by nullFromRight and nullFromLeft. The MZIs applied from the left
+* are moved through the remaining diagonal matrix afterwards, which yields the output phases. Every MZI is applied as
+* a 2x2 rotation of two rows or columns, so the decomposition costs O(N^3).
+* The k-th MZI on the modes (m, m + 1) is placed in column 2k + m % 2 of the mesh. phi and 2 theta are stored like
+* ClementsMesh.flatten_phase in utils/byod_components.py: phi in [0, 2 pi), 2 theta in [0, pi], output phases in [0, 2 pi)
+* @param unitary row-major size x size unitary matrix
+* @param phases size * size phases of the mesh (output)
+*/
+inline void decompose(const std::complex<double>* unitary, uint32_t size, double* phases) {
+
+	struct Placement { uint32_t mode; uint32_t slot; double phi; double theta; };
+
+	std::vector<std::complex<double>> matrix(unitary, unitary + size_t(size) * size);
+	std::vector<uint32_t> forward(size, 0); //next free column slot of the MZIs applied from the right, per mode pair
+	std::vector<uint32_t> backward(size, 0); //next free column slot of the MZIs applied from the left, counting down
+	std::vector<Placement> placements;
+	std::vector<Placement> left;
+	placements.reserve(size_t(size) * (size - 1) / 2);
+
+	for(uint32_t m = 0; m + 1 < size; m++)
+		backward[m] = (size - m % 2 + 1) / 2 - 1; //number of columns of the mode pair minus one
+
+	std::complex<double>* mat = matrix.data();
+	for(uint32_t p = 0; p + 1 < size; p++) {
+		for(uint32_t q = 0; q <= p; q++) {
+
+			Placement mzi;
+			if(p % 2 == 0) { //null the entry (size - 1 - q, p - q) from the right
+				const uint32_t x = size - 1 - q, y = p - q;
+				MZI t = nullFromRight(mat[size_t(x) * size + y], mat[size_t(x) * size + y + 1], mzi.phi, mzi.theta);
+				t.applyRightInverse(mat, size, y);
+				mzi.mode = y;
+				mzi.slot = forward[y]++;
+				placements.push_back(mzi);
+			}
+			else { //null the entry (size - 1 - p + q, q) from the left
+				const uint32_t x = size - 1 - p + q, y = q;
+				MZI t = nullFromLeft(mat[size_t(x - 1) * size + y], mat[size_t(x) * size + y], mzi.phi, mzi.theta);
+				t.applyLeft(mat, size, x - 1, false);
+				mzi.mode = x - 1;
+				mzi.slot = backward[x - 1]--;
+				left.push_back(mzi);
+			}
+		}
+	}
+
+	// the matrix is diagonal now, T_L D = D' T_R moves the MZIs applied from the left to the right of the diagonal
+	for(size_t i = left.size(); i-- > 0; ) {
+
+		Placement mzi = left[i];
+		MZI(mzi.phi, mzi.theta).applyLeft(mat, size, mzi.mode, true);
+		MZI t = nullFromRight(mat[size_t(mzi.mode + 1) * size + mzi.mode], mat[size_t(mzi.mode + 1) * size + mzi.mode + 1], mzi.phi, mzi.theta);
+		t.applyRightInverse(mat, size, mzi.mode);
+		placements.push_back(mzi);
+	}
+
+	for(const Placement &mzi : placements) {
+
+		const uint32_t column = 2 * mzi.slot + mzi.mode % 2;
+		const uint32_t offset = columnOffset(size, column);
+		const uint32_t pair = (mzi.mode - mzi.mode % 2) / 2;
+		phases[offset + pair] = wrapPhase(mzi.phi);
+		phases[offset + pairsInLayer(size, mzi.mode % 2) + pair] = 2.0 * mzi.theta;
+	}
+
+	for(uint32_t i = 0; i < size; i++)
+		phases[columnOffset(size, size) + i] = wrapPhase(std::arg(mat[size_t(i) * size + i]));
+}
+} // namespace ClementsKernels
+} // namespace BYOD
+} // namespace SST
+
+#endif
@@ -0,0 +1,167 @@
+// Copyright (2025) Hewlett Packard Enterprise Development LP
+// 
+// Licensed under the MIT License (the "License")
+//
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "dac_kernels.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <fstream>
+#include <unistd.h>
+
+#include <xtensor-blas/xlinalg.hpp>
+#include <xtensor/containers/xarray.hpp>
+
+namespace SST {
+namespace BYOD {
+namespace DACKernels {
+
+std::vector<double> energyPerValue(DACType dacType, uint32_t resolution, double element, double maxVout, double clockPeriod) {
+
+	std::vector<double> energy(size_t(1) << resolution, 0.0);
+	if (dacType == DACType::CUSTOM)
+		return energy;
+	if (dacType == DACType::R2R) //conductance of the R2R ladder cells
+		element = 1 / element / 2;
+
+	// build initial matrix for conversion nodes
+	xt::xarray<double_t> M = xt::zeros<double_t>({resolution, resolution});
+	M(0, 0) = 4;
+	M(0, 1) = -2;
+
+	for (size_t i = 1; i < resolution - 1; ++i) {
+		M(i, i - 1) = -2;
+		M(i, i) = 5;
+		M(i, i + 1) = -2;
+	}
+
+	M(resolution - 1, resolution - 2) = -2;
+	M(resolution - 1, resolution - 1) = 3;
+	// inverse of conversion node matrix
+	xt::xarray<double_t> conversionNodeMatrix = xt::linalg::inv(M);
+	const double_t* inverse = conversionNodeMatrix.data();
+
+	// the node voltages are linear in the bits, v_k = maxVout * sum_{i set} inv(M)_ki, and only the nodes of set bits
+	// contribute, E = maxVout * element * sum_{k set} (maxVout - v_k)
+	std::vector<uint32_t> setBits(resolution);
+	for (size_t value = 0; value < energy.size(); ++value) {
+
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < resolution; ++i)
+			if ((value >> i) & 1)
+				setBits[count++] = i;
+
+		double_t sum = 0.0;
+		for (uint32_t k = 0; k < count; ++k) {
+			double_t node = 0.0;
+			for (uint32_t i = 0; i < count; ++i)
+				node += inverse[setBits[k] * resolution + setBits[i]];
+			sum += maxVout - maxVout * node;
+		}
+
+		energy[value] = sum * maxVout * element;
+		if (dacType == DACType::R2R)
+			energy[value] *= clockPeriod;
+	}
+
+	return energy;
+}
+
+namespace {
+
+/**
+* @brief exact representation of the DAC parameters, used as registry key and cache file name
+*/
+std::string tableKey(DACType dacType, uint32_t resolution, double element, double maxVout, double clockPeriod) {
+
+	const char* types[] = {"c2c", "r2r", "custom"};
+	uint64_t bits[3];
+	std::memcpy(&bits[0], &element, sizeof(double));
+	std::memcpy(&bits[1], &maxVout, sizeof(double));
+	std::memcpy(&bits[2], &clockPeriod, sizeof(double));
+
+	char key[128];
+	std::snprintf(key, sizeof(key), "%s_%u_%016lx_%016lx_%016lx", types[dacType], resolution, (unsigned long)bits[0], (unsigned long)bits[1], (unsigned long)bits[2]);
+	return key;
+}
+
+const char cacheMagic[8] = {'B', 'Y', 'O', 'D', 'D', 'A', 'C', '1'};
+
+bool readTable(const std::string &path, size_t entries, std::vector<double> &table) {
+
+	std::ifstream file(path, std::ios::binary);
+	char magic[8];
+	uint64_t count = 0;
+	if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, cacheMagic, sizeof(magic)) != 0)
+		return false;
+	if (!file.read(reinterpret_cast<char*>(&count), sizeof(count)) || count != entries)
+		return false;
+
+	table.resize(entries);
+	return bool(file.read(reinterpret_cast<char*>(table.data()), entries * sizeof(double)));
+}
+
+void writeTable(const std::string &path, const std::vector<double> &table) {
+
+	// write to a temporary file first, so concurrent runs never read a partial table
+	const std::string tmp = path + ".tmp." + std::to_string(getpid());
+	std::ofstream file(tmp, std::ios::binary);
+	const uint64_t count = table.size();
+	file.write(cacheMagic, sizeof(cacheMagic));
+	file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+	file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(double));
+	file.close();
+
+	if (!file || std::rename(tmp.c_str(), path.c_str()) != 0)
+		std::remove(tmp.c_str());
+}
+} // namespace
+
+EnergyTable sharedEnergyPerValue(DACType dacType, uint32_t resolution, double element, double maxVout, double clockPeriod, const std::string &cacheDir) {
+
+	static std::mutex registryMutex;
+	static std::map<std::string, std::weak_ptr<const std::vector<double>>> registry;
+
+	const std::string key = tableKey(dacType, resolution, element, maxVout, clockPeriod);
+	std::lock_guard<std::mutex> lock(registryMutex);
+
+	if (EnergyTable table = registry[key].lock())
+		return table;
+
+	auto table = std::make_shared<std::vector<double>>();
+	const std::string path = cacheDir.empty() ? "" : cacheDir + "/dac_energy_" + key + ".bin";
+	if (path.empty() || !readTable(path, size_t(1) << resolution, *table)) {
+
+		*table = energyPerValue(dacType, resolution, element, maxVout, clockPeriod);
+		if (!path.empty())
+			writeTable(path, *table);
+	}
+
+	registry[key] = table;
+	return table;
+}
+} // namespace DACKernels
+} // namespace BYOD
+} // namespace SST
@@ -0,0 +1,86 @@
+#ifndef _dacKernels_H
+#define _dacKernels_H
+
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+
+namespace SST {
+namespace BYOD {
+
+enum DACType { C2C, R2R, CUSTOM };
+
+/**
+* @brief parse the dacType parameter of components containing a DAC
+*/
+inline DACType parseDACStr(std::string str) {
+	std::transform(str.begin(), str.end(), str.begin(),
+				   [](unsigned char c) { return std::tolower(c); });
+	if (str == "c2c") {
+		return DACType::C2C;
+	} else if (str == "r2r") {
+		return DACType::R2R;
+	} else if (str == "custom") {
+		return DACType::CUSTOM;
+	} else {
+		throw std::invalid_argument("DAC type %s not supported.\n");
+	}
+}
+
+/**
+* @brief Energy model of R2R and C2C DACs, shared by the DAC component and components with an embedded DAC.
+*/
+namespace DACKernels {
+
+/**
+* @brief energy for converting every DAC code
+* @details the energy of a code is derived from the voltages at each of the resolution nodes of the ladder.
+* An input code is converted to its binary representation x, the node voltages v solve Mv = x with
+* [x_0]   [ 4  -2   0   0   0  ...]   [v_0]
+* [x_1]   [-2   5  -2   0   0  ...]   [v_1]
+* [x_2] = [ 0  -2   5  -2   0  ...] x [v_2]
+* [...]   [ ......................]   [...]
+* [x_n]   [ 0   0   0  ... -2   3 ]   [v_n]
+* @param dacType R2R or C2C, CUSTOM DACs provide their own table
+* @param element unit resistance (R2R) in Ohm or unit capacitance (C2C) in F
+* @param clockPeriod conversion period in ps
+* @returns table with 2^resolution entries indexed by the DAC code
+*/
+std::vector<double> energyPerValue(DACType dacType, uint32_t resolution, double element, double maxVout, double clockPeriod);
+
+/**
+* @brief output voltage of one LSB of a DAC with the given output range and resolution
+*/
+inline double voltageStep(double minVout, double maxVout, uint32_t resolution) {
+	return (maxVout - minVout) / (std::pow(2, resolution) - 1);
+}
+
+/**
+* @brief output voltages of n codes, T is the packed word type of the resolution
+*/
+template <typename T>
+inline void codesToVoltages(const T* codes, double* voltages, size_t n, double step) {
+
+	for(size_t i = 0; i < n; i++)
+		voltages[i] = step * double(codes[i]);
+}
+
+typedef std::shared_ptr<const std::vector<double>> EnergyTable;
+
+/**
+* @brief energyPerValue shared by all components with the same DAC parameters
+* @details the tables are kept in a process-wide registry guarded by a mutex, so components that are
+* constructed by different SST threads get the same read-only table. If cacheDir is not empty, a table is
+* also stored there as a binary file and loaded instead of recomputed by later runs (e.g. parameter sweeps).
+* Failing to read or write the cache directory only costs the recomputation
+*/
+EnergyTable sharedEnergyPerValue(DACType dacType, uint32_t resolution, double element, double maxVout, double clockPeriod, const std::string &cacheDir = "");
+} // namespace DACKernels
+} // namespace BYOD
+} // namespace SST
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef _detectorKernels_H
+#define _detectorKernels_H
+
+#include <cstddef>
+
+namespace SST {
+namespace BYOD {
+
+/**
+* @brief Kernels for converting an interleaved optical field (re, im, ...) into the output of a photo detector.
+* @details The kernels work in place: entry i is written after entries 2i and 2i + 1 have been read,
+* so the first n entries of the field buffer hold the output afterwards.
+*/
+namespace DetectorKernels {
+
+/**
+* @brief detected signal gain * |E|^2 of n field entries, the intensity is computed in T
+*/
+template <typename T>
+inline void intensities(T* field, size_t n, double gain) {
+
+	for(size_t i = 0; i < n; i++)
+		field[i] = gain * (field[2 * i] * field[2 * i] + field[2 * i + 1] * field[2 * i + 1]);
+}
+
+/**
+* @brief real parts of n field entries
+*/
+template <typename T>
+inline void realParts(T* field, size_t n) {
+
+	for(size_t i = 0; i < n; i++)
+		field[i] = field[2 * i];
+}
+} // namespace DetectorKernels
+} // namespace BYOD
+} // namespace SST
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef _digitalKernels_H
+#define _digitalKernels_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+namespace SST {
+namespace BYOD {
+
+/**
+* @brief Kernels for packing digital codes into the narrowest word of their resolution (see Events/digital_event.h).
+*/
+namespace DigitalKernels {
+
+/**
+* @brief bytes per packed code for a resolution in bits
+*/
+inline uint32_t wordBytes(uint32_t resolution) {
+	return resolution <= 8 ? 1 : resolution <= 16 ? 2 : resolution <= 32 ? 4 : 8;
+}
+
+/**
+* @brief largest code of a resolution in bits, 2^resolution - 1
+*/
+inline uint64_t maxCode(uint32_t resolution) {
+	return resolution >= 64 ? UINT64_MAX : (uint64_t(1) << resolution) - 1;
+}
+
+/**
+* @brief pack n codes into the word type T, codes above maxCode saturate instead of wrapping around the word size
+*/
+template <typename T>
+inline void pack(const uint64_t* codes, T* packed, size_t n, uint64_t maxCode) {
+
+	for(size_t i = 0; i < n; i++)
+		packed[i] = T(std::min(codes[i], maxCode));
+}
+
+/**
+* @brief widen n packed codes to uint64_t
+*/
+template <typename T>
+inline void unpack(const T* packed, uint64_t* codes, size_t n) {
+
+	for(size_t i = 0; i < n; i++)
+		codes[i] = packed[i];
+}
+} // namespace DigitalKernels
+} // namespace BYOD
+} // namespace SST
+
+#endif
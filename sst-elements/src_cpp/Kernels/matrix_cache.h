@@ -0,0 +1,118 @@
+#ifndef _matrixCache_H
+#define _matrixCache_H
+
+#include <cstdint>
+#include <cstring>
+#include <complex>
+#include <list>
+#include <vector>
+#include <unordered_map>
+
+namespace SST {
+namespace BYOD {
+
+/**
+* @brief LRU cache of reconstructed mesh transfer matrices, keyed by the phases of the mesh
+* @details the phases are hashed to find an entry, the stored phases are compared on a hit,
+* so a hash collision is treated as a miss and never returns a wrong matrix.
+* The capacity is limited by the number of entries and/or the number of bytes (0 = no limit),
+* an entry takes the bytes of its phases and its matrix.
+* T is the scalar type of the matrices (double or float, see Events/precision.h), the phases are always double.
+*/
+template <typename T>
+class TransferMatrixCache {
+  public:
+	TransferMatrixCache() {}
+
+	void configure(size_t entries, size_t bytes) {
+		maxEntries = entries;
+		maxBytes = bytes;
+		clear();
+	}
+
+	bool enabled() const { return maxEntries > 0 || maxBytes > 0; }
+	size_t entries() const { return lru.size(); }
+	size_t bytes() const { return usedBytes; }
+
+	void clear() {
+		lru.clear();
+		index.clear();
+		usedBytes = 0;
+	}
+
+	/**
+	* @brief FNV-1a hash over the bit patterns of the phases
+	*/
+	static uint64_t hash(const double* phases, size_t n) {
+
+		uint64_t h = 14695981039346656037ull;
+		for(size_t i = 0; i < n; i++) {
+			uint64_t bits;
+			std::memcpy(&bits, phases + i, sizeof(bits));
+			h = (h ^ bits) * 1099511628211ull;
+		}
+		return h;
+	}
+
+	/**
+	* @brief matrix of the given phases, nullptr on a miss. A hit becomes the most recently used entry
+	*/
+	const std::complex<T>* find(const double* phases, size_t n) {
+
+		auto it = index.find(hash(phases, n));
+		if(it == index.end())
+			return nullptr;
+
+		const Entry &entry = *it->second;
+		if(entry.phases.size() != n || std::memcmp(entry.phases.data(), phases, n * sizeof(double)) != 0)
+			return nullptr;
+
+		lru.splice(lru.begin(), lru, it->second);
+		return entry.matrix.data();
+	}
+
+	/**
+	* @brief store the matrix of the given phases, the least recently used entries are evicted until it fits
+	*/
+	void insert(const double* phases, size_t n, const std::complex<T>* matrix, size_t m) {
+
+		const size_t entryBytes = n * sizeof(double) + m * sizeof(std::complex<T>);
+		if(!enabled() || (maxBytes > 0 && entryBytes > maxBytes))
+			return;
+
+		const uint64_t key = hash(phases, n);
+		auto it = index.find(key);
+		if(it != index.end()) //same hash, replace the entry
+			erase(it);
+
+		while(!lru.empty() && ((maxEntries > 0 && lru.size() >= maxEntries) || (maxBytes > 0 && usedBytes + entryBytes > maxBytes)))
+			erase(index.find(lru.back().key));
+
+		lru.push_front(Entry{key, std::vector<double>(phases, phases + n), std::vector<std::complex<T>>(matrix, matrix + m)});
+		index[key] = lru.begin();
+		usedBytes += entryBytes;
+	}
+
+  private:
+	struct Entry {
+		uint64_t key;
+		std::vector<double> phases;
+		std::vector<std::complex<T>> matrix;
+	};
+
+	void erase(typename std::unordered_map<uint64_t, typename std::list<Entry>::iterator>::iterator it) {
+		usedBytes -= it->second->phases.size() * sizeof(double) + it->second->matrix.size() * sizeof(std::complex<T>);
+		lru.erase(it->second);
+		index.erase(it);
+	}
+
+	size_t maxEntries = 0;
+	size_t maxBytes = 0;
+	size_t usedBytes = 0;
+	std::list<Entry> lru; //most recently used entry first
+	std::unordered_map<uint64_t, typename std::list<Entry>::iterator> index;
+};
+} // namespace BYOD
+} // namespace SST
+
+#endif
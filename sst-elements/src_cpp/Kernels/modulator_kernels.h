@@ -0,0 +1,105 @@
+#ifndef _modulatorKernels_H
+#define _modulatorKernels_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <vector>
+
+namespace SST {
+namespace BYOD {
+
+/**
+* @brief Kernels for converting the voltages applied to an array of modulators.
+* @details All kernels work in place on a contiguous buffer of voltages and are written
+* as plain loops, so the compiler can vectorize them (-fopenmp enables the simd pragmas).
+*/
+namespace ModulatorKernels {
+
+/**
+* @brief phase shift of thermo-optic heaters, phi = pi * V^2 / (R * P_pi)
+*/
+inline void thermoOpticPhases(double* values, size_t n, double resistance, double p_pi) {
+
+	const double scale = M_PI / resistance / p_pi;
+
+	#pragma omp simd
+	for(size_t i = 0; i < n; i++)
+		values[i] = scale * values[i] * values[i];
+}
+
+/**
+* @brief amplitude transmission of thermo-optic modulators, cos(phi)
+*/
+inline void thermoOpticAmplitudes(double* values, size_t n, double resistance, double p_pi) {
+
+	const double scale = M_PI / resistance / p_pi;
+
+	#pragma omp simd
+	for(size_t i = 0; i < n; i++)
+		values[i] = std::cos(scale * values[i] * values[i]);
+}
+
+/**
+* @brief total static power of the heaters, sum(V^2 / R)
+*/
+inline double heaterPower(const double* values, size_t n, double resistance) {
+
+	double power = 0.0;
+
+	#pragma omp simd reduction(+:power)
+	for(size_t i = 0; i < n; i++)
+		power += values[i] * values[i];
+
+	return power / resistance;
+}
+
+/**
+* @brief interleaved field (re, im, ...) of the real amplitudes scaled by scale, with a zero imaginary part
+* @details written back to front, so the amplitudes may be the first half of the field
+*/
+template <typename T>
+inline void interleaveAmplitudes(const double* values, T* field, size_t n, double scale) {
+
+	for(size_t i = n; i-- > 0; ) {
+		field[2 * i] = T(scale * values[i]);
+		field[2 * i + 1] = T(0.0);
+	}
+}
+
+/**
+* @brief lookup tables of a modulator array that is driven by a DAC
+* @details a DAC with a resolution of r bits only outputs the 2^r voltages code * step,
+* so the phase, amplitude and power of every output level can be precomputed once.
+* The tables are indexed by the DAC code.
+*/
+struct VoltageTable {
+
+	double step = 0.0;					//voltage difference between two DAC codes
+	double invStep = 0.0;
+	std::vector<double> voltages;		//output voltage per DAC code
+	std::vector<double> phases;			//phase shift per DAC code
+	std::vector<double> amplitudes;		//amplitude transmission per DAC code
+	std::vector<double> powers;			//static power per DAC code
+
+	bool empty() const { return voltages.empty(); }
+
+	/**
+	* @brief find the DAC code of a voltage
+	* @return false if the voltage is not an output level of the DAC
+	*/
+	inline bool code(double voltage, size_t &k) const {
+
+		const double c = std::nearbyint(voltage * invStep);
+		if(!(c >= 0.0 && c < double(voltages.size())))
+			return false;
+
+		k = size_t(c);
+		return std::abs(voltage - voltages[k]) <= 1e-9 * step;
+	}
+};
+} // namespace ModulatorKernels
+} // namespace BYOD
+} // namespace SST
+
+#endif
@@ -26,6 +26,48 @@
 namespace SST {
 namespace BYOD {
 
+/**
+* @brief convert a buffer of voltages to phases in place
+* @details generic fallback for modulators that only implement the xtensor interface
+*/
+void basicModulator::phasesFromVoltages(double* values, size_t n) {
+
+	auto buffer = xt::adapt(values, n, xt::no_ownership(), std::vector<std::size_t>{n});
+	buffer = getPhasesFromVoltages(buffer);
+}
+
+/**
+* @brief convert a buffer of voltages to amplitudes in place
+* @details generic fallback for modulators that only implement the xtensor interface
+*/
+void basicModulator::amplitudesFromVoltages(double* values, size_t n) {
+
+	auto buffer = xt::adapt(values, n, xt::no_ownership(), std::vector<std::size_t>{n});
+	buffer = getAmplitudesFromVoltages(buffer);
+}
+
+/**
+* @brief convert DAC codes to phases
+* @details generic fallback, the codes are converted to voltages first
+*/
+void basicModulator::phasesFromCodes(const uint64_t* codes, double* values, size_t n, double step) {
+
+	for(size_t i = 0; i < n; i++)
+		values[i] = step * double(codes[i]);
+	phasesFromVoltages(values, n);
+}
+
+/**
+* @brief convert DAC codes to amplitudes
+* @details generic fallback, the codes are converted to voltages first
+*/
+void basicModulator::amplitudesFromCodes(const uint64_t* codes, double* values, size_t n, double step) {
+
+	for(size_t i = 0; i < n; i++)
+		values[i] = step * double(codes[i]);
+	amplitudesFromVoltages(values, n);
+}
+
 /**
 * @brief BRIEF.
 * @details DETAILS
@@ -37,16 +79,139 @@ thermoOpticModulator::thermoOpticModulator(ComponentId_t id, Params &params) : b
 	resistance = 	params.find<double>("resistance", 200);
 	p_pi = 			params.find<double>("p_pi", 200);
 	size = 			params.find<uint32_t>("size", 1);
+	dacResolution = params.find<uint32_t>("dacResolution", 0);
+	dacMinVout = 	params.find<double>("dacMinVout", 0.0);
+	dacMaxVout = 	params.find<double>("dacMaxVout", 1.0);
 
 	// initialize the power and voltages for the modulator
 	staticModulatorPower = 0;
 	switchingEnergy = 0;
 	previousVoltages = xt::zeros<double>({size});
+
+	if(dacResolution > 0 && dacMaxVout > dacMinVout)
+		buildLookupTables();
 }
 
 
 thermoOpticModulator::~thermoOpticModulator() { }
 
+/**
+* @brief precompute phase, amplitude and power for every output level of the driving DAC
+* @details the output levels are computed exactly like DAC::convert, so voltages received from the DAC hit the tables
+*/
+void thermoOpticModulator::buildLookupTables() {
+
+	const size_t levels = size_t(1) << dacResolution;
+	table.step = (dacMaxVout - dacMinVout) / (std::pow(2, dacResolution) - 1);
+	table.invStep = 1.0 / table.step;
+	table.voltages = std::vector<double>(levels);
+
+	for(size_t k = 0; k < levels; k++)
+		table.voltages[k] = table.step * double(k);
+
+	table.phases = table.voltages;
+	table.amplitudes = table.voltages;
+	ModulatorKernels::thermoOpticPhases(table.phases.data(), levels, resistance, p_pi);
+	ModulatorKernels::thermoOpticAmplitudes(table.amplitudes.data(), levels, resistance, p_pi);
+
+	table.powers = std::vector<double>(levels);
+	for(size_t k = 0; k < levels; k++)
+		table.powers[k] = table.voltages[k] * table.voltages[k] / resistance;
+}
+
+/**
+* @brief convert voltages to phases or amplitudes in place and update the static power
+* @details voltages that are output levels of the DAC are looked up in the tables,
+* all other voltages are computed by the vectorized kernels
+*/
+void thermoOpticModulator::convertVoltages(double* values, size_t n, bool amplitudes) {
+
+	if(table.empty()) { //no DAC configured, arbitrary voltages
+
+		staticModulatorPower = ModulatorKernels::heaterPower(values, n, resistance);
+		if(amplitudes)
+			ModulatorKernels::thermoOpticAmplitudes(values, n, resistance, p_pi);
+		else
+			ModulatorKernels::thermoOpticPhases(values, n, resistance, p_pi);
+		return;
+	}
+
+	const std::vector<double> &lut = amplitudes ? table.amplitudes : table.phases;
+	double power = 0.0;
+	size_t code;
+
+	for(size_t i = 0; i < n; i++) {
+		if(table.code(values[i], code)) {
+			power += table.powers[code];
+			values[i] = lut[code];
+		}
+		else { //voltage is not an output level of the DAC
+			power += ModulatorKernels::heaterPower(values + i, 1, resistance);
+			if(amplitudes)
+				ModulatorKernels::thermoOpticAmplitudes(values + i, 1, resistance, p_pi);
+			else
+				ModulatorKernels::thermoOpticPhases(values + i, 1, resistance, p_pi);
+		}
+	}
+	staticModulatorPower = power;
+}
+
+/**
+* @brief read phases or amplitudes of DAC codes directly from the lookup tables
+* @return false if the tables were not built for the given DAC
+*/
+bool thermoOpticModulator::convertCodes(const uint64_t* codes, double* values, size_t n, double step, bool amplitudes) {
+
+	if(table.empty() || std::abs(step - table.step) > 1e-12 * table.step)
+		return false;
+
+	const std::vector<double> &lut = amplitudes ? table.amplitudes : table.phases;
+	const size_t levels = lut.size();
+	double power = 0.0;
+
+	for(size_t i = 0; i < n; i++) {
+		const size_t code = std::min<size_t>(codes[i], levels - 1); //codes are saturated like in a real DAC
+		values[i] = lut[code];
+		power += table.powers[code];
+	}
+	staticModulatorPower = power;
+	return true;
+}
+
+/**
+* @brief convert DAC codes to phases
+*/
+void thermoOpticModulator::phasesFromCodes(const uint64_t* codes, double* values, size_t n, double step) {
+
+	if(!convertCodes(codes, values, n, step, false))
+		basicModulator::phasesFromCodes(codes, values, n, step);
+}
+
+/**
+* @brief convert DAC codes to amplitudes
+*/
+void thermoOpticModulator::amplitudesFromCodes(const uint64_t* codes, double* values, size_t n, double step) {
+
+	if(!convertCodes(codes, values, n, step, true))
+		basicModulator::amplitudesFromCodes(codes, values, n, step);
+}
+
+/**
+* @brief convert a buffer of voltages to phases in place
+*/
+void thermoOpticModulator::phasesFromVoltages(double* values, size_t n) {
+
+	convertVoltages(values, n, false);
+}
+
+/**
+* @brief convert a buffer of voltages to amplitudes in place
+*/
+void thermoOpticModulator::amplitudesFromVoltages(double* values, size_t n) {
+
+	convertVoltages(values, n, true);
+}
+
 /**
 * @brief BRIEF.
 * @details DETAILS
@@ -55,8 +220,7 @@ thermoOpticModulator::~thermoOpticModulator() { }
 */
 xt::xarray<double> thermoOpticModulator::getPhasesFromVoltages(xt::xarray<double> voltages) {
 
-	updateEnergy(voltages);
-	voltages = xt::pow(voltages, 2) / resistance / p_pi * xt::numeric_constants<double>::PI;
+	convertVoltages(voltages.data(), voltages.size(), false);
 	return voltages;
 }
 
@@ -68,8 +232,7 @@ xt::xarray<double> thermoOpticModulator::getPhasesFromVoltages(xt::xarray<double
 */
 xt::xarray<double> thermoOpticModulator::getAmplitudesFromVoltages(xt::xarray<double> voltages) {
 
-	updateEnergy(voltages);
-	voltages = xt::cos(xt::pow(voltages, 2) / resistance / p_pi * xt::numeric_constants<double>::PI);// * xt::cos(xt::pow(voltages, 2) / resistance / p_pi * xt::numeric_constants<double>::PI);
+	convertVoltages(voltages.data(), voltages.size(), true);
 	return voltages;
 }
 
@@ -82,7 +245,7 @@ xt::xarray<double> thermoOpticModulator::getAmplitudesFromVoltages(xt::xarray<do
 void thermoOpticModulator::updateEnergy(xt::xarray<double> voltages) {
 
 	//switchingEnergy = 0; //not implemented right now
-	staticModulatorPower = xt::sum(xt::pow(voltages, 2) / resistance)();
+	staticModulatorPower = ModulatorKernels::heaterPower(voltages.data(), voltages.size(), resistance);
 	//previousVoltages = voltages; //not implemented right now
 }
 
@@ -98,6 +261,15 @@ void thermoOpticModulator::serialize_order(SST::Core::Serialization::serializer&
     SST_SER(resistance);
 	SST_SER(p_pi);
 	SST_SER(size);
+	SST_SER(dacResolution);
+	SST_SER(dacMinVout);
+	SST_SER(dacMaxVout);
+	SST_SER(table.step);
+	SST_SER(table.invStep);
+	SST_SER(table.voltages);
+	SST_SER(table.phases);
+	SST_SER(table.amplitudes);
+	SST_SER(table.powers);
 }
 
 /**
@@ -3,6 +3,7 @@
 
 #include "../../Events/digital_event.h"
 #include "../../Events/analog_event.h"
+#include "../../Kernels/modulator_kernels.h"
 
 #include <cmath>
 #include <util.h>
@@ -40,6 +41,32 @@ class basicModulator : public SST::SubComponent {
     virtual xt::xarray<double> getAmplitudesFromVoltages(xt::xarray<double> voltages) =0;
 	virtual void updateEnergy(xt::xarray<double> voltages) =0;
 
+	/**
+	* @brief convert a buffer of voltages to phases in place and update the static power
+	* @details the default implementation falls back to getPhasesFromVoltages
+	*/
+	virtual void phasesFromVoltages(double* values, size_t n);
+
+	/**
+	* @brief convert a buffer of voltages to amplitudes in place and update the static power
+	* @details the default implementation falls back to getAmplitudesFromVoltages
+	*/
+	virtual void amplitudesFromVoltages(double* values, size_t n);
+
+	/**
+	* @brief convert DAC codes to phases and update the static power
+	* @details the default implementation converts the codes to voltages (code * step, identical to DAC::convert) and calls phasesFromVoltages
+	* @param step voltage difference between two DAC codes
+	*/
+	virtual void phasesFromCodes(const uint64_t* codes, double* values, size_t n, double step);
+
+	/**
+	* @brief convert DAC codes to amplitudes and update the static power
+	* @details the default implementation converts the codes to voltages (code * step, identical to DAC::convert) and calls amplitudesFromVoltages
+	* @param step voltage difference between two DAC codes
+	*/
+	virtual void amplitudesFromCodes(const uint64_t* codes, double* values, size_t n, double step);
+
     double staticModulatorPower; //variable to store current static power drain
     double switchingEnergy; //variable to store 
     uint32_t size; //number of modulators
@@ -73,6 +100,9 @@ public:
 		{ "resistance",     "Ohmic resistance of the heater in Ohm", "1" },
 		{ "p_pi",           "Electric power needed to induces a pi phase shift in W", "1" },
         { "size",           "Size of the modulator array", "1"},
+		{ "dacResolution",  "Resolution of the DAC driving the modulators, enables lookup tables indexed by the DAC code (0 disables the tables)", "0" },
+		{ "dacMinVout",     "Minimal output voltage of the DAC driving the modulators in V", "0" },
+		{ "dacMaxVout",     "Maximal output voltage of the DAC driving the modulators in V", "1" },
 	)
 
     thermoOpticModulator(ComponentId_t id, Params& params);
@@ -81,6 +111,10 @@ public:
 	xt::xarray<double> getPhasesFromVoltages(xt::xarray<double> voltages) override;
     xt::xarray<double> getAmplitudesFromVoltages(xt::xarray<double> voltages) override;
 	void updateEnergy(xt::xarray<double> voltages) override;
+	void phasesFromVoltages(double* values, size_t n) override;
+	void amplitudesFromVoltages(double* values, size_t n) override;
+	void phasesFromCodes(const uint64_t* codes, double* values, size_t n, double step) override;
+	void amplitudesFromCodes(const uint64_t* codes, double* values, size_t n, double step) override;
 
     // serialization
     thermoOpticModulator() : basicModulator() {};
@@ -88,8 +122,16 @@ public:
     ImplementSerializable(SST::BYOD::thermoOpticModulator);
 
 private:
+	void buildLookupTables();
+	void convertVoltages(double* values, size_t n, bool amplitudes);
+	bool convertCodes(const uint64_t* codes, double* values, size_t n, double step, bool amplitudes);
+
     double resistance;
 	double p_pi;
+	uint32_t dacResolution;
+	double dacMinVout;
+	double dacMaxVout;
+	ModulatorKernels::VoltageTable table; //lookup tables per DAC code, empty if dacResolution is 0
 };
 
 /**
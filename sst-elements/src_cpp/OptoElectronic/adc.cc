@@ -39,14 +39,20 @@ ADC::ADC(ComponentId_t id, Params &params) : Component(id) {
 	maxVin = 				params.find<double>("maxVin", 1.0);
 	conversionEnergy = 		params.find<double>("conversionEnergy", 0.0);
 	frequency = 			params.find<UnitAlgebra>("frequency", "1GHz");
+	inputQueueDepth = 		std::max(params.find<uint32_t>("inputQueueDepth", 1), uint32_t(1));
 
 	energyConsumption = 	registerStatistic<double_t>("energyADC");
+	queueOccupancy = 		registerStatistic<uint32_t>("queueOccupancy");
+	stallCycles = 			registerStatistic<uint64_t>("stallCycles");
+	droppedEvents = 		registerStatistic<uint64_t>("droppedEvents");
 
 	selfLink = 				configureSelfLink("selfLink", new Event::Handler<ADC>(this, &ADC::handleSelf));
 	inputLink = 			configureLink("input",	new Event::Handler<ADC>(this, &ADC::handleInput));
 	outputLink = 			configureLink("output");
 
-	registerClock(frequency, new Clock::Handler<ADC>(this, &ADC::clockTick));
+	clockHandler = 			new Clock::Handler<ADC>(this, &ADC::clockTick);
+	clockTC = 				registerClock(frequency, clockHandler);
+	clockPeriod = 1 / frequency.getDoubleValue() * 1e12;
 
 	std::string prefix = "@t\t@X\t[ADC::" + std::to_string(id) + "]:\t";
 	outputStr.init(prefix, verbose, 0, SST::Output::STDOUT);
@@ -54,7 +60,9 @@ ADC::ADC(ComponentId_t id, Params &params) : Component(id) {
 	nanoTimeConverter = getTimeConverter("1ns");
 	picoTimeConverter = getTimeConverter("1ps");
 
-	inputEvent = NULL;
+	busyUntil = 0;
+	clockSuspended = false;
+	lastCycle = 0;
 	lastSwitch = 0;
 }
 
@@ -78,12 +86,15 @@ void ADC::init(unsigned int phase){
 		if (event->getMax() > maxVin) { //check for correct vmax of input vector
 			outputStr.fatal(CALL_INFO, -1, "Error in %s: Analog data received at input port has a vmax of %f V, while the internal vmax is %f V. Please make sure that vmax of connected components is smaller or equal to the \"maxVin/vout\" parameter\n", getName().c_str(), event->getMax(), maxVin);
 		}
-		if (event->getData().size() != size) { //check for correct size of input vector
-			outputStr.fatal(CALL_INFO, -1, "Error in %s: Data received at input port has a size of %u, while the expected size is %u. Please make sure that size of connected components is identical to the \"size\" parameter \n", getName().c_str(), int(event->getData().size()), size);
+		if (event->getSize() != size) { //check for correct size of input vector
+			outputStr.fatal(CALL_INFO, -1, "Error in %s: Data received at input port has a size of %u, while the expected size is %u. Please make sure that size of connected components is identical to the \"size\" parameter \n", getName().c_str(), int(event->getSize()), size);
 		}
 		if (event) {
-			auto output = this->convert(event->getData());
-			outputLink->sendUntimedData(new DigitalEvent(event->getId(), resolution, output));
+			DigitalEvent *output = new DigitalEvent(event->getId(), resolution, event->getSize());
+			event->visitData([&](const auto* voltages, size_t) {
+				output->visitCodes([&](auto* codes, size_t n) { convert(voltages, codes, n); });
+			});
+			outputLink->sendUntimedData(output);
 		}
 	}
 }
@@ -92,6 +103,12 @@ void ADC::init(unsigned int phase){
 void ADC::finish() {
 
 	updateEnergy();
+
+	if (clockSuspended) { //the cycles after the last clock tick had an empty queue, the occupancy has one sample per cycle like with an always-on clock
+		const Cycle_t currentCycle = getCurrentSimTime(clockTC);
+		if (currentCycle > lastCycle)
+			queueOccupancy->addDataNTimes(currentCycle - lastCycle, 0);
+	}
 }
 
 /**
@@ -100,29 +117,54 @@ void ADC::finish() {
 */
 bool ADC::clockTick(Cycle_t cycle) {
 
-	if (inputEvent != NULL) {
-		selfLink->send(latency, picoTimeConverter, inputEvent);
-		inputEvent = NULL;
+	queueOccupancy->addData(inputQueue.size());
+	lastCycle = cycle;
+
+	if (inputQueue.empty()) { //nothing to convert, suspend the clock until the next input event
+		clockSuspended = true;
+		return true;
 	}
+	if (cycle < busyUntil) { //the previous batch is still being converted
+		stallCycles->addData(1);
+		return false;
+	}
+
+	Event *inputEvent = inputQueue.front();
+	inputQueue.pop();
+
+	// a batch of vectors is converted one vector per clock cycle
+	uint32_t batchSize = static_cast<AnalogEvent *>(inputEvent)->getBatchSize();
+	busyUntil = cycle + batchSize;
+	selfLink->send(latency + SimTime_t((batchSize - 1) * clockPeriod), picoTimeConverter, inputEvent);
 	return false;
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
+* @brief queue an incoming event until the ADC is free, events arriving at a full queue are dropped
 */
 void ADC::handleInput(Event *ev) {
 
 	outputStr.verbose(CALL_INFO, 2, 0, "event received\n ");
 
-	delete inputEvent;
-	
-	inputEvent = ev;
+	if (inputQueue.size() >= inputQueueDepth) {
+		outputStr.verbose(CALL_INFO, 1, 0, "input queue full, event %u dropped\n", static_cast<AnalogEvent *>(ev)->getId());
+		droppedEvents->addData(1);
+		delete ev;
+		return;
+	}
+	inputQueue.push(ev);
+
+	if (clockSuspended) { //re-arm the clock at the next clock edge, the skipped cycles had an empty queue
+		Cycle_t nextCycle = reregisterClock(clockTC, clockHandler);
+		queueOccupancy->addDataNTimes(nextCycle - lastCycle - 1, 0);
+		clockSuspended = false;
+	}
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
+* @brief convert a batch of voltages, the voltages are read directly from the input event
+* @details the codes are written packed into the output event, its payload is taken from the payload pool.
+* The voltages (double or single precision) return to the pool with the input event
 */
 void ADC::handleSelf(Event *ev) {
 
@@ -130,25 +172,26 @@ void ADC::handleSelf(Event *ev) {
 	
 	outputStr.verbose(CALL_INFO, 2, 0, "event sent\n ");
 
-	auto output = this->convert(input->getData());
+	DigitalEvent *output = new DigitalEvent(input->getId(), resolution, input->getSize(), input->getBatchSize());
+	{
+		AllocationScope scope(selfAllocations);
+		input->visitData([&](const auto* voltages, size_t) {
+			output->visitCodes([&](auto* codes, size_t n) { convert(voltages, codes, n); });
+		});
+	}
 
-	outputLink->send(new DigitalEvent(input->getId(), resolution, output));
+	outputLink->send(output);
 	
 	delete input;
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
+* @brief quantize n voltages to codes, In is the scalar type of the voltages, T is the packed word type of the resolution
 */
-std::vector<uint64_t> ADC::convert(std::vector<double> input) {
-
-	auto output = std::vector<uint64_t>(input.size(), 0);
-	auto output_ = xt::adapt(output, {size});
-
-	output_ = xt::cast<uint64_t>(xt::adapt(input, {size}) / ((maxVin - minVin) / ((pow(2, resolution) - 1) )));
+template <typename In, typename T>
+void ADC::convert(const In* input, T* output, size_t n) {
 
-	return output;
+	ADCKernels::quantize(input, output, n, ADCKernels::quantizationStep(minVin, maxVin, resolution), DigitalKernels::maxCode(resolution));
 }
 
 /**
@@ -3,8 +3,11 @@
 
 #include "../Events/digital_event.h"
 #include "../Events/analog_event.h"
+#include "../Kernels/allocation_counter.h"
+#include "../Kernels/adc_kernels.h"
 
 #include <cstdint>
+#include <queue>
 #include <math.h>
 
 #include <sst/core/component.h>
@@ -44,15 +47,19 @@ class ADC : public SST::Component {
 		{"maxVin", 			"(double) maximum value of the output vector", "0"},
 		{"conversionEnergy","(double) energy per ADC conversion in pJ", "1"},
 		{"frequency", 		"(string) clock frequency", "1GHz"},
+		{"inputQueueDepth",	"(uint32) number of input events buffered in front of the ADC, events arriving at a full queue are dropped. The ADC has no credit port: the photo detector, mesh and modulator in front of it cannot hold back data, so the ADC only counts the drops in droppedEvents. Backpressure ends at the DAC", "1"},
 	);
 
 	SST_ELI_DOCUMENT_PORTS(
-		{"input", 			"receiving input signal (analog)", {"sst.byod.analogEvent"}},
-		{"output", 			"sending output signal (digital)", {"sst.byod.digitalEvent"}}
+		{"input", 			"receiving input signal (analog), single or batched vectors", {"sst.byod.analogEvent"}},
+		{"output", 			"sending output signal (digital), same batch size as the input", {"sst.byod.digitalEvent"}}
 	);
 
 	SST_ELI_DOCUMENT_STATISTICS(
-		{"energyADC", 		"Cumulative energy consumption of ADC", "pJ", 1}
+		{"energyADC", 		"Cumulative energy consumption of ADC", "pJ", 1},
+		{"queueOccupancy", 	"Number of events in the input queue, sampled every clock cycle", "events", 1},
+		{"stallCycles", 	"Clock cycles in which events wait in the input queue while the ADC is busy", "cycles", 1},
+		{"droppedEvents", 	"Events dropped because the input queue was full", "events", 1}
 	);
 
 	ADC(ComponentId_t id, Params &params);
@@ -65,7 +72,7 @@ class ADC : public SST::Component {
 	bool clockTick(Cycle_t cycle);
 	void handleInput(Event *ev);
 	void handleSelf(Event *ev);
-	std::vector<uint64_t> convert(std::vector<double> input);
+	template <typename In, typename T> void convert(const In* input, T* output, size_t n);
 	void updateEnergy();
 
   private:
@@ -89,18 +96,28 @@ class ADC : public SST::Component {
 	double minVin;
 	double maxVin;
 	double conversionEnergy;
+	double clockPeriod;
+	uint32_t inputQueueDepth;
 
 	/** Statistics *********************************************/
 
 	Statistic<double> *energyConsumption;
+	Statistic<uint32_t> *queueOccupancy;
+	Statistic<uint64_t> *stallCycles;
+	Statistic<uint64_t> *droppedEvents;
 
 	/** operation *********************************************/
 
-	Event *inputEvent;
+	std::queue<Event *> inputQueue;
+	Cycle_t busyUntil; //first cycle in which the ADC can start the next conversion
+	TimeConverter *clockTC;
+	Clock::HandlerBase *clockHandler;
+	bool clockSuspended; //the clock is unregistered while the input queue is empty
+	Cycle_t lastCycle; //last cycle the clock handler was called
 	SimTime_t lastSwitch;
 	TimeConverter *nanoTimeConverter;
 	TimeConverter *picoTimeConverter;
-
+	AllocationCheck selfAllocations{"ADC::handleSelf"};
 };
 } // namespace BYOD
 } // namespace SST
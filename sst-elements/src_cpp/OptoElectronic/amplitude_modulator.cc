@@ -37,6 +37,7 @@ amplitudeModulator::amplitudeModulator(ComponentId_t id, Params &params) : Compo
 	laserPower = 		params.find<double>("laserPower", 1.0);
 	laserWpe = 			params.find<double>("laserWpe", 0.2);
 	opticalLoss = 		params.find<double>("opticalLoss", 0.0);
+	precision = 		parsePrecisionStr(params.find<std::string>("precision", "double"));
 
 	energyConsumption = registerStatistic<double_t>("energyModulator");
 
@@ -58,8 +59,8 @@ amplitudeModulator::amplitudeModulator(ComponentId_t id, Params &params) : Compo
 	nanoTimeConverter = getTimeConverter("1ns");
 	picoTimeConverter = getTimeConverter("1ps");
 
-	empty = std::vector<double>(size, 0);
 	lastSwitch = 0;
+	modulatorPower = 0.0;
 }
 
 /**
@@ -87,17 +88,26 @@ void amplitudeModulator::init(unsigned int phase){
 		//if (event->getVmax() != resolution) { //check for correct resolution/vmax of input vector
 		//	output.fatal(CALL_INFO, -1, "Error in %s: Analog data received at input port has a vmax of %f V, while the internal vmax is %f V. Please make sure that vmax of connected components is identical by setting the \"max_vin/vout\" parameter\n", getName().c_str(), event->getResolution(), resolution);
 		//}
-		if (event->getData().size() != size) { //check for correct size of input vector
+		if (event->getSize() != size) { //check for correct size of input vector
 			outputStr.fatal(
 				CALL_INFO, -1,
 				"Error in %s: Data received at input port has a size of %u, while the expected size is %u. Please make sure that size of connected components is identical to the \"size\" parameter \n", 
-				getName().c_str(), int(event->getData().size()), size);
+				getName().c_str(), int(event->getSize()), size);
 		}
-		if(event) {
+		if(event && precision == Precision::Single) { //the downstream components check the precision of the field
+
+			Payload<float> field(2 * size, 0.0f);
+			event->visitData([&field](const auto* voltages, size_t n) {
+				for(size_t i = 0; i < n; i++)
+					field[2 * i] = float(voltages[i]);
+			});
+			outputLink->sendUntimedData(new ComplexEvent(event->getId(), 0.0, std::move(field)));
+		}
+		else if(event) {
 
-			auto XTinputData = xt::adapt(event->getData(), {size});
+			xt::xarray<double> XTinputData = xt::adapt(event->getData(), {size});
 			XTinputData = sqrt(laserPower) * sqrt(1 - opticalLoss) * XTinputData; //TODO!!!
-			outputLink->sendUntimedData(new ComplexEvent(event->getId(), 0.0, event->getData(), empty));
+			outputLink->sendUntimedData(new ComplexEvent(event->getId(), 0.0, event->getData(), Payload<double>(size, 0.0)));
 		}
 	}
 }
@@ -130,15 +140,46 @@ void amplitudeModulator::handleSelf(Event *ev) {
 
 	updateEnergy();
 
-	xt::xarray<double> XTinputData = xt::adapt(input->getData(), {size});
-	XTinputData = sqrt(laserPower) * sqrt(1 - opticalLoss) * modulator->getAmplitudesFromVoltages(XTinputData);
-	std::vector<double> output(XTinputData.begin(), XTinputData.end());
-
-	outputLink->send(new ComplexEvent(input->getId(), 0.0, output, empty));
+	if(precision == Precision::Single)
+		modulate<float>(input);
+	else
+		modulate<double>(input);
 	
 	delete input;
 }
 
+/**
+* @brief modulate a batch into an optical field with the scalar type T (double or float)
+* @details the amplitudes are always computed in double, in the buffer of the field for double precision
+* and in the amplitudes workspace for single precision. Only the field is rounded to T
+*/
+template <typename T>
+void amplitudeModulator::modulate(AnalogEvent *input) {
+
+	uint32_t batchSize = input->getBatchSize();
+	size_t n = input->getSize();
+	Payload<T> output;
+	{
+		AllocationScope scope(selfAllocations);
+		output = PayloadPool<T>::acquire(2 * n); //the field has twice the entries of the voltages, the voltages return to the pool with the input event
+		double* values;
+		if constexpr (std::is_same<T, double>::value)
+			values = output.data(); //the amplitudes are computed in the first half of the field
+		else {
+			growWorkspace(amplitudes, n); //grows to the largest batch
+			values = amplitudes.data();
+		}
+		input->visitData([values](const auto* voltages, size_t count) { std::copy(voltages, voltages + count, values); });
+		modulator->amplitudesFromVoltages(values, n);
+		modulatorPower = modulator->staticModulatorPower / batchSize; //the modulator power is computed over all vectors of the batch, the average per vector drives the energy
+
+		// interleave the real amplitudes with a zero imaginary part (re, im, ...), back to front so it can be done in place
+		ModulatorKernels::interleaveAmplitudes(values, output.data(), n, sqrt(laserPower) * sqrt(1 - opticalLoss));
+	}
+
+	outputLink->send(new ComplexEvent(input->getId(), 0.0, std::move(output), batchSize));
+}
+
 /**
 * @brief BRIEF.
 * @details DETAILS
@@ -148,7 +189,7 @@ void amplitudeModulator::updateEnergy() {
 	SimTime_t currentTime = getCurrentSimTime(picoTimeConverter);
 	SimTime_t elapsedTime = currentTime - lastSwitch;
 
-	energyConsumption->addData( elapsedTime * (size * laserPower / laserWpe + modulator->staticModulatorPower) + modulator->switchingEnergy);
+	energyConsumption->addData( elapsedTime * (size * laserPower / laserWpe + modulatorPower) + modulator->switchingEnergy);
 
 	lastSwitch = currentTime;
 }
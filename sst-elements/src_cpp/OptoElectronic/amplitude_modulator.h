@@ -4,6 +4,7 @@
 #include "../Events/complex_event.h"
 #include "../Events/analog_event.h"
 #include "Submodules/modulators.h"
+#include "../Kernels/allocation_counter.h"
 
 #include <math.h>
 #include <util.h>
@@ -43,11 +44,12 @@ class amplitudeModulator : public SST::Component {
 		{"laserPower", 		"(double) optical power provided by each single laser in the modulator array in W", "1"},
 		{"laserWpe", 		"(double) wall-plug efficiency by each single laser in the modulator array", "1"},
 		{"insertionLoss", 	"(double) optical insertion loss by each single laser in the modulator array", "1"},
+		{"precision", 		"(string) double or single: scalar type of the optical field sent to the mesh", "double"},
 	);
 
 	SST_ELI_DOCUMENT_PORTS(
-		{"input", 			"receiving input signal (analog)", {"sst.byod.analogEvent"}},
-		{"output", 			"sending output signal (complex)", {"sst.byod.complexEvent"}}
+		{"input", 			"receiving input signal (analog), single or batched vectors", {"sst.byod.analogEvent"}},
+		{"output", 			"sending output signal (complex), same batch size as the input", {"sst.byod.complexEvent"}}
 	);
 
 	SST_ELI_DOCUMENT_STATISTICS(
@@ -67,6 +69,7 @@ class amplitudeModulator : public SST::Component {
 
 	void handleInput(Event *ev);
 	void handleSelf(Event *ev);
+	template <typename T> void modulate(AnalogEvent *input);
 	void updateEnergy();
 
   private:
@@ -87,6 +90,7 @@ class amplitudeModulator : public SST::Component {
 	double laserPower;
 	double laserWpe;
 	double opticalLoss;
+	Precision precision;
 
 	/** Statistics *********************************************/
 
@@ -97,10 +101,12 @@ class amplitudeModulator : public SST::Component {
 	TimeConverter *nanoTimeConverter;
 	TimeConverter *picoTimeConverter;
 	SimTime_t lastSwitch;
+	AllocationCheck selfAllocations{"amplitudeModulator::handleSelf"};
+	Payload<double> amplitudes; //amplitudes of one batch in single precision mode, the field is rounded to float from here
 	SST::BYOD::basicModulator* modulator;
-	std::vector<double> empty;
 	uint32_t verbose;
 	double modulatorEnergy;
+	double modulatorPower; //static power of the modulators averaged over the vectors of the last batch
 };
 } // namespace BYOD
 } // namespace SST
@@ -35,8 +35,16 @@ clements::clements(ComponentId_t id, Params &params) : Component(id) {
 
 	size = 				params.find<uint32_t>("size", 1);
 	latency = 			params.find<uint32_t>("latency", 1);
+	programmingLatency = params.find<uint32_t>("programmingLatency", 0);
+	numThreads = 		std::max<uint32_t>(1, params.find<uint32_t>("numThreads", 1));
 	verbose = 			params.find<uint32_t>("verbose", 0);
 	opticalLoss = 		params.find<double>("opticalLoss", 0.0);
+	propagationMode = 	parsePropagationModeStr(params.find<std::string>("propagationMode", "matrix"));
+	precision = 		parsePrecisionStr(params.find<std::string>("precision", "double"));
+	if(precision == Precision::Single) //only the matrices of the configured precision are cached
+		buffersSingle.matrixCache.configure(params.find<uint32_t>("matrixCacheEntries", 0), params.find<uint64_t>("matrixCacheBytes", 0));
+	else
+		buffersDouble.matrixCache.configure(params.find<uint32_t>("matrixCacheEntries", 0), params.find<uint64_t>("matrixCacheBytes", 0));
 
 	inputDataLink = 		configureLink("inputData",	new Event::Handler<clements>(this, &clements::handleDataInput));
 	inputWeightLink = 		configureLink("inputWeight",	new Event::Handler<clements>(this, &clements::handleWeightInput));
@@ -45,6 +53,8 @@ clements::clements(ComponentId_t id, Params &params) : Component(id) {
 
 	modulator = 		loadUserSubComponent<basicModulator>("modulator");
 	energyConsumption = registerStatistic<double_t>("energyMesh");
+	cacheHits = 		registerStatistic<uint64_t>("matrixCacheHits");
+	cacheMisses = 		registerStatistic<uint64_t>("matrixCacheMisses");
 
 	nanoTimeConverter = getTimeConverter("1ns");
 	picoTimeConverter = getTimeConverter("1ps");
@@ -59,13 +69,43 @@ clements::clements(ComponentId_t id, Params &params) : Component(id) {
 			"check that 'modulator' slot is filled in input.\n");
 	}
 
-	transfer_matrix = xt::eye(size);
-	even_dc_couplers = dc_coupler(0);
-	odd_dc_couplers = dc_coupler(1);
+	if(propagationMode == PropagationMode::Matrix) { //the layered mode only stores the phases
+
+		if(precision == Precision::Single)
+			buffersSingle.transfer_matrix = xt::eye<std::complex<float>>(size);
+		else
+			buffersDouble.transfer_matrix = xt::eye(size);
+	}
 	phases = xt::zeros<double>({size * size});
+	nextPhases = phases;
+	shadowPending = false;
+	shadowFirstVector = 0;
+	shadowReadyTime = 0;
+	shadowModulatorPower = 0.0;
+	if(precision == Precision::Single) //grows to the largest batch
+		buffersSingle.workspace.resize(2 * size);
+	else
+		buffersDouble.workspace.resize(2 * size);
+	buffersDouble.kernels = ClementsKernels::selectKernels<double>(size); //fixed-size kernels for the sizes 4, 8 and 16
+	buffersSingle.kernels = ClementsKernels::selectKernels<float>(size);
+	if(propagationMode == PropagationMode::Layered) { //rotations of the configured precision, data of the other precision adds its own on the first batch
+
+		if(precision == Precision::Single)
+			buffersSingle.rotations.resize(2 * size * size);
+		else
+			buffersDouble.rotations.resize(2 * size * size);
+		updateRotations();
+	}
 	lastSwitch = 0;
 }
 
+clements::~clements() {
+
+	while(!heldWeights.empty()) { //weight sets whose first vector never arrived
+		delete heldWeights.front();
+		heldWeights.pop();
+	}
+}
 
 void clements::setup() { }
 
@@ -88,11 +128,17 @@ void clements::init(unsigned int phase){
 				"Error in %s: Expected input port to be connected to an Element with complex output. Please check that components connected to %s have the correct output type\n", 
 				getName().c_str(), getName().c_str());
         } 
-		if (event->getReal().size() != size) { //check for correct size of input vector
+		if (event->getSize() != size) { //check for correct size of input vector
 			outputStr.fatal(
 				CALL_INFO, -1, 
 				"Error in %s: Data received at input port has a size of %u, while the expected size is %u. Please make sure that size of connected components is identical to the \"size\" parameter \n", 
-				getName().c_str(), int(event->getReal().size()), size);
+				getName().c_str(), int(event->getSize()), size);
+		}
+		if (propagationMode == PropagationMode::Matrix && event->isSinglePrecision() != (precision == Precision::Single)) { //check for the precision of the transfer matrix
+			outputStr.fatal(
+				CALL_INFO, -1, 
+				"Error in %s: Data received at input port has %s precision, while the transfer matrix has %s precision. Please make sure that the \"precision\" parameter of connected components is identical \n", 
+				getName().c_str(), event->isSinglePrecision() ? "single" : "double", precision == Precision::Single ? "single" : "double");
 		}
 		if(event) {
 			//TODO!!!
@@ -110,17 +156,16 @@ void clements::init(unsigned int phase){
 				"Error in %s: Expected input port to be connected to an Element with analog output. Please check that components connected to %s have the correct output type\n", 
 				getName().c_str(), getName().c_str());
         } 
-		if (event2->getData().size() != (size * size)) { //check for correct size of input vector
-			outputStr.fatal(
-				CALL_INFO, -1, 
-				"Error in %s: Data received at input port has a size of %u, while the internal size is %u. Please make sure that size of connected components is identical by setting the \"size\" parameter \n", 
-				getName().c_str(), int(event2->getData().size()), (size * size));
-		}
+		checkWeights(*event2);
 		if(event2) {
 				xt::xarray<double> voltages = xt::adapt(event2->getData(), {size * size});
 				phases = modulator->getPhasesFromVoltages(voltages);
-				reconstructUnitaryMatrix();
-				std::cout << transfer_matrix << " here's your matrix" << std::endl;
+				if(propagationMode == PropagationMode::Layered)
+					updateRotations();
+				if(propagationMode == PropagationMode::Matrix) {
+					reconstructUnitaryMatrix();
+					outputStr.verbose(CALL_INFO, 1, 0, "transfer matrix of %u x %u reconstructed from the initial weights\n", size, size);
+				}
 		}
 	}
 
@@ -145,133 +190,209 @@ void clements::finish() {
 */
 void clements::handleDataInput(Event *ev) {
 
-	selfLink->send(latency, picoTimeConverter, ev);
+	SimTime_t delay = latency;
+	SimTime_t currentTime = getCurrentSimTime(picoTimeConverter);
+	if(shadowPending && static_cast<ComplexEvent *>(ev)->getId() >= shadowFirstVector && shadowReadyTime > currentTime) //the data waits until the shadow weights are programmed
+		delay += shadowReadyTime - currentTime;
+
+	selfLink->send(delay, picoTimeConverter, ev);
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
-* @param PARAMETER PARAMETER DESCRIPTION
-* @return RETURN
+* @brief check the size of a weight set, during init and the simulation
+*/
+void clements::checkWeights(const AnalogEvent &input) {
+
+	if (input.getData().size() != (size * size)) { //check for correct size of input vector
+		outputStr.fatal(
+			CALL_INFO, -1, 
+			"Error in %s: Data received at inputWeight port has a size of %u, while the internal size is %u. Please make sure that size of connected components is identical by setting the \"size\" parameter \n", 
+			getName().c_str(), int(input.getData().size()), (size * size));
+	}
+}
+
+/**
+* @brief weight update during the simulation, the weights are programmed into the shadow buffer
+* @details the active weights stay in use until the first data vector of the new weight set (the id of the weight event) arrives.
+* There is only one shadow buffer, a weight set that arrives while the previous set is still pending is held back
+* and programmed when the previous set is swapped in (see swapShadow)
 */
 void clements::handleWeightInput(Event *ev) {
 
 	AnalogEvent *input = static_cast<AnalogEvent *>(ev);
-	updateEnergy();
-	xt::xarray<double> voltages = xt::adapt(input->getData(),{size * size});
-	phases = modulator->getPhasesFromVoltages(voltages);
-	reconstructUnitaryMatrix();
+	checkWeights(*input);
+	if(shadowPending) {
+		outputStr.verbose(CALL_INFO, 1, 0, "weight set for vector %u received before the weight set for vector %u was used, it is programmed after the swap\n", input->getId(), shadowFirstVector);
+		heldWeights.push(input);
+		return;
+	}
 
-	delete input;
+	stageShadow(input);
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
-* @param PARAMETER PARAMETER DESCRIPTION
-* @return RETURN
+* @brief program a weight set into the shadow buffer and delete the event
 */
-void clements::handleSelf(Event *ev) {
+void clements::stageShadow(AnalogEvent *input) {
 
-	ComplexEvent *input = static_cast<ComplexEvent *>(ev);
-	xt::xarray<std::complex<double>> signal = xt::adapt(input->getReal(),{size}) + jj * xt::adapt(input->getImag(),{size});
-	
-	signal = xt::linalg::dot(transfer_matrix, signal); //TODO add optical loss!!!
-	
-	std::vector<double> signal_real(xt::real(signal).begin(), xt::real(signal).end());
-	std::vector<double> signal_imag(xt::imag(signal).begin(), xt::imag(signal).end());
-    ComplexEvent* output = new ComplexEvent(input->getId(), 3.0, signal_real, signal_imag);
-	outputLink->send(output);
+	updateEnergy();
+	const double activeModulatorPower = modulator->staticModulatorPower;
+	std::copy(input->getData().begin(), input->getData().end(), nextPhases.begin());
+	modulator->phasesFromVoltages(nextPhases.data(), nextPhases.size()); //the phases are converted in place, without temporaries
+	shadowModulatorPower = modulator->staticModulatorPower;
+	modulator->staticModulatorPower = activeModulatorPower; //the active weights keep driving the mesh until the swap
+
+	shadowFirstVector = input->getId();
+	shadowReadyTime = getCurrentSimTime(picoTimeConverter) + programmingLatency;
+	shadowPending = true;
 
 	delete input;
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
-* @param PARAMETER PARAMETER DESCRIPTION
-* @return RETURN
+* @brief swap the programmed shadow weights in, the swap is atomic with respect to the data vectors
 */
-void clements::reconstructUnitaryMatrix() {
-
-	transfer_matrix = xt::eye(size);
+void clements::swapShadow() {
 
-	int32_t index_counter = 0;
-
-	for(int i = 0; i < size; i++) {
- 
-		phase_shifter(i%2, index_counter, 1.0);
-		transfer_matrix = xt::linalg::tensordot(mesh_layer, transfer_matrix, 1);
-		index_counter += int(floor((size - i%2) / 2));
+	updateEnergy();
+	modulator->staticModulatorPower = shadowModulatorPower;
+	std::swap(phases, nextPhases);
+	if(propagationMode == PropagationMode::Matrix)
+		reconstructUnitaryMatrix();
+	else //the layered mode works on the rotations of the phases directly
+		updateRotations();
+	shadowPending = false;
+
+	if(!heldWeights.empty()) { //the shadow buffer is free, the oldest held back weight set starts programming
+		AnalogEvent *next = heldWeights.front();
+		heldWeights.pop();
+		stageShadow(next);
+	}
+}
 
-		if(i%2 == 0)
-			transfer_matrix = xt::linalg::tensordot(even_dc_couplers, transfer_matrix, 1);
+/**
+* @brief e^{j phi} of the current phases in the precisions in use, so the layered mode does not evaluate cos and sin per event
+*/
+void clements::updateRotations() {
 
-		else
-			transfer_matrix = xt::linalg::tensordot(odd_dc_couplers, transfer_matrix, 1);
+	if(!buffersDouble.rotations.empty())
+		ClementsKernels::phaseRotations(phases.data(), size, buffersDouble.rotations.data());
+	if(!buffersSingle.rotations.empty())
+		ClementsKernels::phaseRotations(phases.data(), size, buffersSingle.rotations.data());
+}
 
-		phase_shifter(i%2, index_counter, 1.0);
-		transfer_matrix = xt::linalg::tensordot(mesh_layer, transfer_matrix, 1);
-		index_counter += int(floor((size - i%2) / 2));
+/**
+* @brief propagate a batch through the mesh
+* @details the field is computed in the buffer of the input event and the per-instance workspace,
+* which only grows until it holds the largest batch, so a warm handler does not allocate
+*/
+void clements::handleSelf(Event *ev) {
 
-		if(i%2 == 0)
-			transfer_matrix = xt::linalg::tensordot(even_dc_couplers, transfer_matrix, 1);
+	ComplexEvent *input = static_cast<ComplexEvent *>(ev);
+	while(shadowPending && input->getId() >= shadowFirstVector) { //first data vector of the new weight set
 
-		else
-			transfer_matrix = xt::linalg::tensordot(odd_dc_couplers, transfer_matrix, 1);
+		const SimTime_t currentTime = getCurrentSimTime(picoTimeConverter);
+		if(shadowReadyTime > currentTime) { //the set was held back behind the previous one and is still being programmed
+			selfLink->send(shadowReadyTime - currentTime, picoTimeConverter, input);
+			return;
+		}
+		swapShadow();
+	}
 
+	if (propagationMode == PropagationMode::Matrix && input->isSinglePrecision() != (precision == Precision::Single)) { //init() only sees the data of components that send init data, e.g. not of an upstream mesh
+		outputStr.fatal(
+			CALL_INFO, -1, 
+			"Error in %s: Data received at input port has %s precision, while the transfer matrix has %s precision. Please make sure that the \"precision\" parameter of connected components is identical \n", 
+			getName().c_str(), input->isSinglePrecision() ? "single" : "double", precision == Precision::Single ? "single" : "double");
 	}
 
-	diagonals(index_counter);
-	transfer_matrix = xt::linalg::tensordot(mesh_layer, transfer_matrix, 1);
+	if(input->isSinglePrecision())
+		propagateBatch<float>(input);
+	else
+		propagateBatch<double>(input);
+
+	delete input;
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
-* @param PARAMETER PARAMETER DESCRIPTION
-* @return RETURN
+* @brief propagate a batch with the field type T (double or float) through the mesh
+* @details the layered mode works with either precision, the matrix mode multiplies with the transfer matrix
+* of the configured precision, handleSelf() checks that the data has the same precision
 */
-xt::xarray<std::complex<double>> clements::dc_coupler(int32_t start) {
-
-	xt::xarray<std::complex<double>> out = xt::eye(size);
-
-	for(int i = start; i < size - 1; i +=2 )
-		xt::view(out, xt::range(i,i+2), xt::range(i,i+2)) = beam_splitter_matrix;
+template <typename T>
+void clements::propagateBatch(ComplexEvent *input) {
+
+	MeshBuffers<T> &mesh = buffers<T>();
+	std::vector<T> &workspace = mesh.workspace;
+	uint32_t batchSize = input->getBatchSize();
+	// the interleaved field of the input event is adapted in place and reused for the output event
+	Payload<T> buffer = input->releaseField<T>();
+	growWorkspace(workspace, buffer.size());
+	if(propagationMode == PropagationMode::Layered && mesh.rotations.empty()) { //first batch with the precision that was not configured
+
+		mesh.rotations.resize(2 * size * size);
+		ClementsKernels::phaseRotations(phases.data(), size, mesh.rotations.data());
+	}
+	{
+		AllocationScope scope(selfAllocations);
+		std::complex<T>* field = reinterpret_cast<std::complex<T>*>(buffer.data());
+		std::complex<T>* work = reinterpret_cast<std::complex<T>*>(workspace.data());
+
+		if(propagationMode == PropagationMode::Layered) //fixed-size kernel of a small mesh or the generic kernels on the transposed batch
+			ClementsKernels::propagateBatch(mesh.kernels, field, work, size, batchSize, mesh.rotations.data());
+		else { //all vectors of the batch in one GEMM, one row per vector, TODO add optical loss!!!
+
+			if(mesh.kernels.multiply) //fixed-size kernel of a small mesh instead of the BLAS call
+				mesh.kernels.multiply(field, mesh.transfer_matrix.data(), work, batchSize);
+			else {
+
+				auto signal = xt::adapt(field, batchSize * size, xt::no_ownership(), std::array<std::size_t, 2>{batchSize, size});
+				auto product = xt::adapt(work, batchSize * size, xt::no_ownership(), std::array<std::size_t, 2>{batchSize, size});
+				xt::blas::gemm(signal, mesh.transfer_matrix, product, false, true);
+			}
+			ClementsKernels::takeProduct(buffer, workspace); //the product is sent, the input buffer becomes the next workspace
+		}
+	}
 
-	return out; 
+    ComplexEvent* output = new ComplexEvent(input->getId(), 3.0, std::move(buffer), batchSize);
+	outputLink->send(output);
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
-* @param PARAMETER PARAMETER DESCRIPTION
-* @return RETURN
+* @brief reconstruct the transfer matrix of the mesh from the current phases in the configured precision
 */
-void clements::phase_shifter(int32_t start, int32_t start_index, double multiplier = 1.0) {
-
-	mesh_layer = xt::eye(size);
-	int32_t counter = start_index;
+void clements::reconstructUnitaryMatrix() {
 
-	for(int i = start; i < size - 1; i +=2 ) {
-		mesh_layer(i, i) = exp(phases(counter) * multiplier * jj);
-		counter++;
-	}
+	if(precision == Precision::Single)
+		reconstructUnitaryMatrix<float>();
+	else
+		reconstructUnitaryMatrix<double>();
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
-* @param PARAMETER PARAMETER DESCRIPTION
-* @return RETURN
+* @brief reconstruct the transfer matrix with the scalar type T
+* @details every MZI column is applied in place as 2x2 row rotations on the
+* transfer matrix (see Kernels/clements_kernels.h), no dense layer matrices are built.
+* Matrices of phases that were programmed before are copied from the matrix cache
 */
-void clements::diagonals(int32_t start_index) {
+template <typename T>
+void clements::reconstructUnitaryMatrix() {
+
+	MeshBuffers<T> &mesh = buffers<T>();
+	if(mesh.matrixCache.enabled()) {
 
-	mesh_layer = xt::eye(size);
+		if(const std::complex<T>* cached = mesh.matrixCache.find(phases.data(), phases.size())) {
+			std::copy(cached, cached + size * size, mesh.transfer_matrix.data());
+			cacheHits->addData(1);
+			return;
+		}
+		cacheMisses->addData(1);
+	}
 
-	for(int i = 0; i < size; i++)
-		mesh_layer(i,i) = exp(phases(start_index + i) * jj);
+	ClementsKernels::reconstruct(mesh.transfer_matrix.data(), size, phases.data(), numThreads);
 
+	if(mesh.matrixCache.enabled())
+		mesh.matrixCache.insert(phases.data(), phases.size(), mesh.transfer_matrix.data(), size * size);
 }
 
 /**
@@ -4,9 +4,13 @@
 #include "../Events/complex_event.h"
 #include "../Events/analog_event.h"
 #include "Submodules/modulators.h"
+#include "../Kernels/clements_kernels.h"
+#include "../Kernels/matrix_cache.h"
+#include "../Kernels/allocation_counter.h"
 
 #include <cstdint>
 #include <complex>
+#include <queue>
 #include <cmath>
 #include <util.h>
 
@@ -47,16 +51,24 @@ class clements : public SST::Component {
 		{"verbose", 		"(uint32) level of debuggin output", "0"},
 		{"opticalLoss", 	"(double) total optical intensity loss of the mesh in percentage", "0"},
 		{"maxVin", 			"(double) maximal input voltage for the phase shifters in V", "0"},
+		{"propagationMode", "(string) matrix: multiply data with the dense transfer matrix, layered: propagate data through the MZI columns without building the matrix", "matrix"},
+		{"matrixCacheEntries","(uint32) max. number of transfer matrices kept in the LRU cache of reconstructed matrices, 0 for no limit. The cache is disabled if matrixCacheEntries and matrixCacheBytes are 0", "0"},
+		{"matrixCacheBytes", "(uint64) max. size of the LRU cache of reconstructed matrices in bytes (phases and matrix of each entry), 0 for no limit", "0"},
+		{"numThreads", 		"(uint32) number of OpenMP threads used for rebuilding the transfer matrix after a weight update, 1 rebuilds it on the calling thread", "1"},
+		{"programmingLatency","(uint32) time in ps for programming a weight set received during the simulation into the shadow buffer of the mesh", "0"},
+		{"precision", 		"(string) double or single: scalar type of the transfer matrix. Matrix mode expects data of the same precision, layered mode follows the precision of the data (the phase rotations of the other precision are only stored once such data arrives)", "double"},
 	);
 
 	SST_ELI_DOCUMENT_PORTS(
-		{"inputData", 		"receiving input signal (complex)", {"sst.byod.complexEvent"}},
+		{"inputData", 		"receiving input signal (complex), single or batched vectors", {"sst.byod.complexEvent"}},
 		{"inputWeight", 	"receiving weight input signal (analog)", {"sst.byod.analogEvent"}},
-		{"output", 			"sending output signal (complex)", {"sst.byod.complexEvent"}}
+		{"output", 			"sending output signal (complex), same batch size as the input", {"sst.byod.complexEvent"}}
 	);
 
 	SST_ELI_DOCUMENT_STATISTICS(
-		{"energyMesh", 		"Cumulative energy consumption of the optical mesh and the optical modulators", "pJ", 1}
+		{"energyMesh", 		"Cumulative energy consumption of the optical mesh and the optical modulators", "pJ", 1},
+		{"matrixCacheHits", "Number of weight updates whose transfer matrix was found in the matrix cache", "count", 1},
+		{"matrixCacheMisses","Number of weight updates whose transfer matrix was reconstructed and added to the matrix cache", "count", 1}
 	);
 
 	SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS(
@@ -64,7 +76,7 @@ class clements : public SST::Component {
 	);
 
 	clements(ComponentId_t id, Params &params);
-	~clements() {};
+	~clements();
 
 	void setup();
 	void finish();
@@ -72,8 +84,14 @@ class clements : public SST::Component {
 
 	void handleDataInput(Event *ev);
 	void handleWeightInput(Event *ev);
+	void checkWeights(const AnalogEvent &input);
+	void stageShadow(AnalogEvent *input);
 	void handleSelf(Event *ev);
+	template <typename T> void propagateBatch(ComplexEvent *input);
+	void swapShadow();
 	void reconstructUnitaryMatrix();
+	template <typename T> void reconstructUnitaryMatrix();
+	void updateRotations();
 	void updateEnergy();
 
   private:
@@ -92,13 +110,19 @@ class clements : public SST::Component {
 
 	uint32_t size;
 	uint32_t latency;
+	uint32_t programmingLatency;
+	uint32_t numThreads;
 	uint32_t verbose;
 	double opticalLoss;
 	double maxVin;
+	PropagationMode propagationMode;
+	Precision precision;
 
 	/** Statistics *********************************************/
 
 	Statistic<double_t> *energyConsumption;
+	Statistic<uint64_t> *cacheHits;
+	Statistic<uint64_t> *cacheMisses;
 
 	/** operation *********************************************/
 
@@ -109,21 +133,36 @@ class clements : public SST::Component {
 
 	SimTime_t lastSwitch;
 
-	xt::xarray<std::complex<double>> transfer_matrix;
-	xt::xarray<std::complex<double>> mesh_layer;
+	/**
+	* @brief buffers and kernels of the mesh whose scalar type depends on the precision, only the set of the configured precision holds a matrix
+	*/
+	template <typename T>
+	struct MeshBuffers {
+		ClementsKernels::MeshKernels<T> kernels; //fixed-size kernels, nullptr for sizes other than 4, 8 and 16
+		std::vector<T> rotations; //e^{j phi} of the phases, only used in layered mode
+		xt::xarray<std::complex<T>> transfer_matrix;
+		TransferMatrixCache<T> matrixCache; //transfer matrices of previous weight sets
+		Payload<T> workspace; //interleaved field of one batch, swapped with the buffer of the input event after a GEMM
+	};
+
+	template <typename T>
+	MeshBuffers<T>& buffers() {
+		if constexpr (std::is_same<T, float>::value)
+			return buffersSingle;
+		else
+			return buffersDouble;
+	}
+
+	MeshBuffers<double> buffersDouble;
+	MeshBuffers<float> buffersSingle;
 	xt::xarray<double> phases;
-	xt::xarray<std::complex<double>> odd_dc_couplers;
-	xt::xarray<std::complex<double>> even_dc_couplers;
-
-	const std::complex<double> jj = std::complex<double>(0.0, 1.0);
-	const xt::xarray<std::complex<double>> beam_splitter_matrix
-      {{1 / sqrt(2.0), 1 / sqrt(2.0) * jj},
-       {1 / sqrt(2.0) * jj, 1 / sqrt(2.0)}};
-
-	void diagonals(xt::xarray<std::complex<double>> phases);
-	xt::xarray<std::complex<double>> dc_coupler(int32_t start);
-	void phase_shifter(int32_t start, int32_t start_index, double multiplier);
-	void diagonals(int32_t start_index);
+	xt::xarray<double> nextPhases; //shadow buffer for weights received during the simulation
+	bool shadowPending; //the shadow buffer holds a weight set that has not been swapped in yet
+	std::queue<AnalogEvent *> heldWeights; //weight sets received while shadowPending, programmed in order of arrival after each swap
+	uint32_t shadowFirstVector; //id of the first data vector computed with the shadow weights
+	SimTime_t shadowReadyTime; //time in ps when programming the shadow weights is complete
+	double shadowModulatorPower;
+	AllocationCheck selfAllocations{"clements::handleSelf"};
 };
 } // namespace BYOD
 } // namespace SST
@@ -33,15 +33,35 @@ clementsSVD::clementsSVD(ComponentId_t id, Params &params) : Component(id) {
 
 	size = 				params.find<uint32_t>("size", 1);
 	latency = 			params.find<uint32_t>("latency", 1);
+	programmingLatency = params.find<uint32_t>("programmingLatency", 0);
+	numThreads = 		std::max<uint32_t>(1, params.find<uint32_t>("numThreads", 1));
+	matrixCheckpoint = 	params.find<bool>("matrixCheckpoint", false);
 	verbose = 			params.find<uint32_t>("verbose", 0);
 	opticalLoss = 		params.find<double>("opticalLoss", 0.0);
+	propagationMode = 	parsePropagationModeStr(params.find<std::string>("propagationMode", "matrix"));
+	precision = 		parsePrecisionStr(params.find<std::string>("precision", "double"));
+	if(precision == Precision::Single) //only the matrices of the configured precision are cached
+		buffersSingle.matrixCache.configure(params.find<uint32_t>("matrixCacheEntries", 0), params.find<uint64_t>("matrixCacheBytes", 0));
+	else
+		buffersDouble.matrixCache.configure(params.find<uint32_t>("matrixCacheEntries", 0), params.find<uint64_t>("matrixCacheBytes", 0));
+	dacType = 			parseDACStr(params.find<std::string>("dacType", "R2R"));
+	dacResolution = 	params.find<uint32_t>("dacResolution", 8);
+	dacMinVout = 		params.find<double>("dacMinVout", 0.0);
+	dacMaxVout = 		params.find<double>("dacMaxVout", 1.0);
+	dacElement = 		params.find<double>("dacElement", dacType == DACType::R2R ? 5e3 : 1e-12);
+	dacControllerEnergy = params.find<double>("dacControllerEnergy", 1);
+	dacFrequency = 		params.find<UnitAlgebra>("dacFrequency", "1GHz");
 
 	inputDataLink = 	configureLink("inputData",	new Event::Handler<clementsSVD>(this, &clementsSVD::handleDataInput));
 	inputWeightLink = 	configureLink("inputWeight", new Event::Handler<clementsSVD>(this, &clementsSVD::handleWeightInput));
+	inputWeightDigitalLink = configureLink("inputWeightDigital", new Event::Handler<clementsSVD>(this, &clementsSVD::handleDigitalWeightInput));
 	selfLink = 			configureSelfLink("selfLink", new Event::Handler<clementsSVD>(this, &clementsSVD::handleSelf));
 	outputLink = 		configureLink("output");
 
 	energyConsumption = registerStatistic<double_t>("energyMesh");
+	dacEnergyConsumption = registerStatistic<double_t>("energyDAC");
+	cacheHits = 		registerStatistic<uint64_t>("matrixCacheHits");
+	cacheMisses = 		registerStatistic<uint64_t>("matrixCacheMisses");
 	modulator = 		loadUserSubComponent<basicModulator>("modulator");
 
 	nanoTimeConverter = getTimeConverter("1ns");
@@ -57,15 +77,84 @@ clementsSVD::clementsSVD(ComponentId_t id, Params &params) : Component(id) {
 			"check that 'modulator' slot is filled in input.\n");
 	}
 
-	transfer_matrix = xt::eye(size);
-	full_matrix = xt::eye(size);
-	even_dc_couplers = dc_coupler(0);
-	odd_dc_couplers = dc_coupler(1);
-	phases = xt::zeros<double>({size * size});
+	phasesU = xt::zeros<double>({size * size});
+	phasesS = xt::ones<double>({size});
+	phasesV = xt::zeros<double>({size * size});
+	nextU = phasesU;
+	nextS = phasesS;
+	nextV = phasesV;
+	if(propagationMode == PropagationMode::Matrix && precision == Precision::Single) { //the layered mode only stores the phases
+
+		buffersSingle.full_matrix = xt::eye<std::complex<float>>(size);
+		if(matrixCheckpoint)
+			buffersSingle.checkpoint = xt::eye<std::complex<float>>(size);
+	}
+	else if(propagationMode == PropagationMode::Matrix) {
+
+		buffersDouble.full_matrix = xt::eye(size);
+		if(matrixCheckpoint)
+			buffersDouble.checkpoint = xt::eye<std::complex<double>>(size);
+	}
+	checkpointStage = 0;
+	shadowPending = false;
+	shadowFirstVector = 0;
+	shadowReadyTime = 0;
+	activeModulatorPower = 0.0;
+	shadowModulatorPower = 0.0;
+	if(precision == Precision::Single) //grows to the largest batch
+		buffersSingle.workspace.resize(2 * size);
+	else
+		buffersDouble.workspace.resize(2 * size);
+	buffersDouble.kernels = ClementsKernels::selectKernels<double>(size); //fixed-size kernels for the sizes 4, 8 and 16
+	buffersSingle.kernels = ClementsKernels::selectKernels<float>(size);
+	if(propagationMode == PropagationMode::Layered) { //rotations of the configured precision, data of the other precision adds its own on the first batch
+
+		if(precision == Precision::Single) {
+			buffersSingle.rotationsU.resize(2 * size * size);
+			buffersSingle.rotationsV.resize(2 * size * size);
+		}
+		else {
+			buffersDouble.rotationsU.resize(2 * size * size);
+			buffersDouble.rotationsV.resize(2 * size * size);
+		}
+		updateRotations();
+	}
+	if(propagationMode == PropagationMode::Matrix) //later updates only rebuild the stages that changed
+		reconstructFullMatrix();
 	lastSwitch = 0;
 	modulator->size = size;
+
+	// the fused weight DAC uses the same energy model as the DAC component
+	dacClockPeriod = 1 / dacFrequency.getDoubleValue() * 1e12;
+	dacCurrentEnergy = 0.0;
+	if(inputWeightDigitalLink) {
+
+		if(dacType != DACType::CUSTOM)
+			dacEnergyPerValue = DACKernels::sharedEnergyPerValue(dacType, dacResolution, dacElement, dacMaxVout, dacClockPeriod, params.find<std::string>("dacEnergyCacheDir", ""));
+		else {
+
+			std::vector<double> customEnergy;
+			params.find_array("dacEnergyPerValue", customEnergy);
+			if(customEnergy.size() != std::pow(2, dacResolution)) {
+
+				outputStr.output(
+					CALL_INFO, 
+					"Warning in %s: Size of dacEnergyPerValue is %lu, while the internal size is %f. dacEnergyPerValue will be set to zero \n", 
+					getName().c_str(), customEnergy.size(), std::pow(2, dacResolution));
+				customEnergy = std::vector<double>(std::pow(2, dacResolution), 0.0);
+			}
+			dacEnergyPerValue = std::make_shared<const std::vector<double>>(std::move(customEnergy));
+		}
+	}
 }
 
+clementsSVD::~clementsSVD() {
+
+	while(!heldWeights.empty()) { //weight sets whose first vector never arrived
+		delete heldWeights.front();
+		heldWeights.pop();
+	}
+}
 
 void clementsSVD::setup() { }
 
@@ -86,18 +175,24 @@ void clementsSVD::init(unsigned int phase){
 				"Error in %s: Expected input port to be connected to an Element with complex output. Please check that components connected to %s have the correct output type\n", 
 				getName().c_str(), getName().c_str());
         } 
-		if (event->getReal().size() != size) { //check for correct size of input vector
+		if (event->getSize() != size) { //check for correct size of input vector
 			outputStr.fatal(
 				CALL_INFO, -1, 
 				"Error in %s: Data received at input port has a size of %u, while the expected size is %u. Please make sure that size of connected components is identical to the \"size\" parameter \n", 
-				getName().c_str(), int(event->getReal().size()), size);
+				getName().c_str(), int(event->getSize()), size);
+		}
+		if (propagationMode == PropagationMode::Matrix && event->isSinglePrecision() != (precision == Precision::Single)) { //check for the precision of the full matrix
+			outputStr.fatal(
+				CALL_INFO, -1, 
+				"Error in %s: Data received at input port has %s precision, while the full matrix has %s precision. Please make sure that the \"precision\" parameter of connected components is identical \n", 
+				getName().c_str(), event->isSinglePrecision() ? "single" : "double", precision == Precision::Single ? "single" : "double");
 		}
 		if(event) {
 			//TODO!!!
 		}
 	}
 
-	while (SST::Event* ev = inputWeightLink->recvUntimedData()) 
+	while (SST::Event* ev = inputWeightLink ? inputWeightLink->recvUntimedData() : nullptr) 
 	{
 		
 		AnalogEvent* event2 = dynamic_cast<AnalogEvent*>(ev);
@@ -108,24 +203,29 @@ void clementsSVD::init(unsigned int phase){
 				"Error in %s: Expected input port to be connected to an Element with analog output. Please check that components connected to %s have the correct output type\n", 
 				getName().c_str(), getName().c_str());
         } 
-		if (event2->getData().size() != (2 * size * size + size)) { //check for correct size of input vector
-			outputStr.fatal(
-				CALL_INFO, -1, 
-				"Error in %s: Data received at input port has a size of %u, while the internal size is %u. Please make sure that size of connected components is identical by setting the \"size\" parameter \n", 
-				getName().c_str(), int(event2->getData().size()), (2 * size * size + size));
-		}
+		checkWeights(*event2);
 		if(event2) { //initialize weights
 
-			xt::xarray<double> voltages = xt::adapt(event2->getData(),{2*size*size + size});
-			
-			phasesU = modulator->getPhasesFromVoltages(xt::view(voltages, xt::range(0, size * size)));
-			phasesS = modulator->getAmplitudesFromVoltages(xt::view(voltages, xt::range(size * size, size * size + size)));
-			phasesV = modulator->getPhasesFromVoltages(xt::view(voltages, xt::range(size * size + size, 2 * size * size + size)));
-			reconstructFullMatrix();
-
+			stageWeightVoltages(event2->getData());
+			updateWeights();
 			//std::cout << full_matrix << " here's your matrix" << std::endl;
 		}
 	}
+
+	while (SST::Event* ev = inputWeightDigitalLink ? inputWeightDigitalLink->recvUntimedData() : nullptr) 
+	{
+		DigitalEvent* event3 = dynamic_cast<DigitalEvent*>(ev);
+
+        if (!event3) { //check for correct data type of input vector
+            outputStr.fatal(
+				CALL_INFO, -1, 
+				"Error in %s: Expected inputWeightDigital port to be connected to an Element with digital output. Please check that components connected to %s have the correct output type\n", 
+				getName().c_str(), getName().c_str());
+        } 
+		checkWeights(*event3);
+		stageWeightCodes(*event3); //initialize weights
+		updateWeights();
+	}
 }
 
 /**
@@ -143,159 +243,391 @@ void clementsSVD::finish() {
 */
 void clementsSVD::handleDataInput(Event *ev) {
 
-	selfLink->send(latency, picoTimeConverter, ev);
+	SimTime_t delay = latency;
+	SimTime_t currentTime = getCurrentSimTime(picoTimeConverter);
+	if(shadowPending && static_cast<ComplexEvent *>(ev)->getId() >= shadowFirstVector && shadowReadyTime > currentTime) //the data waits until the shadow weights are programmed
+		delay += shadowReadyTime - currentTime;
+
+	selfLink->send(delay, picoTimeConverter, ev);
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
+* @brief check the size of a weight set (voltages), during init and the simulation
+*/
+void clementsSVD::checkWeights(const AnalogEvent &input) {
+
+	if (input.getData().size() != (2 * size * size + size)) { //check for correct size of input vector
+		outputStr.fatal(
+			CALL_INFO, -1, 
+			"Error in %s: Data received at inputWeight port has a size of %u, while the internal size is %u. Please make sure that size of connected components is identical by setting the \"size\" parameter \n", 
+			getName().c_str(), int(input.getData().size()), (2 * size * size + size));
+	}
+}
+
+/**
+* @brief check the resolution and size of a weight set (DAC codes), during init and the simulation
+*/
+void clementsSVD::checkWeights(const DigitalEvent &input) {
+
+	if (input.getResolution() != dacResolution) {
+		outputStr.fatal(
+			CALL_INFO, -1, 
+			"Error in %s: Data received at inputWeightDigital port has a resolution of %u, while the expected resolution is %u. Please make sure that the resolution of connected components is identical to the \"dacResolution\" parameter \n", 
+			getName().c_str(), input.getResolution(), dacResolution);
+	}
+	if (input.getSize() != (2 * size * size + size)) { //check for correct size of input vector
+		outputStr.fatal(
+			CALL_INFO, -1, 
+			"Error in %s: Data received at inputWeightDigital port has a size of %u, while the internal size is %u. Please make sure that size of connected components is identical by setting the \"size\" parameter \n", 
+			getName().c_str(), int(input.getSize()), (2 * size * size + size));
+	}
+}
+
+/**
+* @brief weight update during the simulation, the weights are programmed into the shadow buffers
+* @details the active weights stay in use until the first data vector of the new weight set (the id of the weight event) arrives.
+* There is only one shadow buffer, a weight set that arrives while the previous set is still pending is held back
+* and programmed when the previous set is swapped in (see swapShadow)
 */
 void clementsSVD::handleWeightInput(Event *ev) {
 
 	AnalogEvent *input = static_cast<AnalogEvent *>(ev);
-	updateEnergy();
-	xt::xarray<double> voltages = xt::adapt(input->getData(),{2*size*size + size});
-	
-	phasesU = modulator->getPhasesFromVoltages(xt::view(voltages, xt::range(0, size * size)));
-	phasesS = modulator->getAmplitudesFromVoltages(xt::view(voltages, xt::range(size * size, size * size + size)));
-	phasesV = modulator->getPhasesFromVoltages(xt::view(voltages, xt::range(size * size + size, 2 * size * size + size)));
-	reconstructFullMatrix();
+	checkWeights(*input);
+	if(shadowPending) {
+		holdWeights(input, input->getId());
+		return;
+	}
 
-	delete input;
+	stageShadow(input);
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
+* @brief map voltages [U: size * size, S: size, V: size * size] to the phases of the mesh
+* @details the weights are copied into the staging buffers and converted in place, without temporaries
 */
-void clementsSVD::reconstructFullMatrix() {
+void clementsSVD::stageWeightVoltages(const Payload<double> &voltages) {
 
-	full_matrix = xt::eye(size);
+	const double* data = voltages.data();
+
+	std::copy(data, data + size * size, nextU.begin());
+	std::copy(data + size * size, data + size * size + size, nextS.begin());
+	std::copy(data + size * size + size, data + 2 * size * size + size, nextV.begin());
+	modulator->phasesFromVoltages(nextU.data(), nextU.size());
+	modulator->amplitudesFromVoltages(nextS.data(), nextS.size());
+	modulator->phasesFromVoltages(nextV.data(), nextV.size());
+}
 
-	phases = phasesU;
-	reconstructUnitaryMatrix();
-	full_matrix = xt::linalg::tensordot(full_matrix, transfer_matrix, 1);
+/**
+* @brief weight update with DAC codes, the DAC and modulator conversion are fused into one lookup
+*/
+void clementsSVD::handleDigitalWeightInput(Event *ev) {
 
-	phases = phasesS; 
-	reconstructDiagonalMatrix();
-	full_matrix = xt::linalg::tensordot(full_matrix, mesh_layer, 1);
+	DigitalEvent *input = static_cast<DigitalEvent *>(ev);
+	checkWeights(*input);
+	if(shadowPending) {
+		holdWeights(input, input->getId());
+		return;
+	}
 
-	phases = phasesV;
-	reconstructUnitaryMatrix();
-	full_matrix = xt::linalg::tensordot(full_matrix, transfer_matrix, 1);
+	stageShadow(input);
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
+* @brief keep a weight set that arrived while the shadow buffers hold a pending set
 */
-void clementsSVD::handleSelf(Event *ev) {
+void clementsSVD::holdWeights(Event *ev, uint32_t firstVector) {
 
-	ComplexEvent *input = static_cast<ComplexEvent *>(ev);
-	xt::xarray<std::complex<double>> signal = xt::adapt(input->getReal(),{size}) + jj * xt::adapt(input->getImag(),{size});
-	
-	signal = xt::linalg::dot(full_matrix, signal); //TODO add optical loss!!!
+	outputStr.verbose(CALL_INFO, 1, 0, "weight set for vector %u received before the weight set for vector %u was used, it is programmed after the swap\n", firstVector, shadowFirstVector);
+	heldWeights.push(ev);
+}
 
-	std::vector<double> signal_real(xt::real(signal).begin(), xt::real(signal).end());
-	std::vector<double> signal_imag(xt::imag(signal).begin(), xt::imag(signal).end());
+/**
+* @brief program a weight set (AnalogEvent or DigitalEvent) into the shadow buffers and delete the event
+*/
+void clementsSVD::stageShadow(Event *ev) {
 
-    ComplexEvent* output = new ComplexEvent(input->getId(), 3.0, signal_real, signal_imag);
-	outputLink->send(output);
+	if(DigitalEvent *codes = dynamic_cast<DigitalEvent *>(ev)) {
+		beginShadowUpdate(codes->getId());
+		stageWeightCodes(*codes);
+	}
+	else {
+		AnalogEvent *voltages = static_cast<AnalogEvent *>(ev);
+		beginShadowUpdate(voltages->getId());
+		stageWeightVoltages(voltages->getData());
+	}
+	endShadowUpdate();
 
-	delete input;
+	delete ev;
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
+* @brief map DAC codes [U: size * size, S: size, V: size * size] to the phases of the mesh
+* @details the codes are converted by the code->phase tables of the modulator, the voltages in between are never materialized.
+* The DAC energy is computed from the codes, like DAC::currentForConversion.
+* The packed codes are widened once into weightCodes, which is kept for the next weight set
 */
-void clementsSVD::reconstructUnitaryMatrix() {
+void clementsSVD::stageWeightCodes(const DigitalEvent &input) {
 
-	transfer_matrix = xt::eye(size);
+	weightCodes.resize(input.getSize());
+	input.unpack(weightCodes.data());
+	const std::vector<uint64_t> &codes = weightCodes;
 
-	int32_t index_counter = 0;
+	const double step = (dacMaxVout - dacMinVout) / (std::pow(2, dacResolution) - 1); //voltage per code, identical to DAC::convert
+	const uint64_t* data = codes.data();
 
-	for(int i = 0; i < size; i++) {
- 
-		phase_shifter(i%2, index_counter, 1.0);
-		transfer_matrix = xt::linalg::tensordot(mesh_layer, transfer_matrix, 1);
-		index_counter += int(floor((size - i%2) / 2));
+	modulator->phasesFromCodes(data, nextU.data(), size * size, step);
+	modulator->amplitudesFromCodes(data + size * size, nextS.data(), size, step);
+	modulator->phasesFromCodes(data + size * size + size, nextV.data(), size * size, step);
 
-		if(i%2 == 0)
-			transfer_matrix = xt::linalg::tensordot(even_dc_couplers, transfer_matrix, 1);
+	const std::vector<double> &energy = *dacEnergyPerValue;
+	dacCurrentEnergy = dacControllerEnergy * codes.size();
+	for(size_t i = 0; i < codes.size(); i++)
+		dacCurrentEnergy += energy[std::min<size_t>(codes[i], energy.size() - 1)];
+}
 
-		else
-			transfer_matrix = xt::linalg::tensordot(odd_dc_couplers, transfer_matrix, 1);
+/**
+* @brief prepare the shadow buffers for a weight set received during the simulation
+* @param firstVector id of the first data vector computed with the new weight set
+*/
+void clementsSVD::beginShadowUpdate(uint32_t firstVector) {
 
-		phase_shifter(i%2, index_counter, 1.0);
-		transfer_matrix = xt::linalg::tensordot(mesh_layer, transfer_matrix, 1);
-		index_counter += int(floor((size - i%2) / 2));
+	updateEnergy();
+	activeModulatorPower = modulator->staticModulatorPower;
+	shadowFirstVector = firstVector;
+}
 
-		if(i%2 == 0)
-			transfer_matrix = xt::linalg::tensordot(even_dc_couplers, transfer_matrix, 1);
+/**
+* @brief mark the shadow buffers as pending, the active weights keep driving the mesh until the swap
+*/
+void clementsSVD::endShadowUpdate() {
+
+	shadowModulatorPower = modulator->staticModulatorPower; //the modulator conversion already set the power of the new weights
+	modulator->staticModulatorPower = activeModulatorPower;
+	shadowReadyTime = getCurrentSimTime(picoTimeConverter) + programmingLatency;
+	shadowPending = true;
+}
 
-		else
-			transfer_matrix = xt::linalg::tensordot(odd_dc_couplers, transfer_matrix, 1);
+/**
+* @brief swap the programmed shadow weights in, the swap is atomic with respect to the data vectors
+* @details the shadow buffers are free afterwards, so the oldest held back weight set starts programming
+*/
+void clementsSVD::swapShadow() {
 
+	updateEnergy();
+	modulator->staticModulatorPower = shadowModulatorPower;
+	updateWeights();
+	shadowPending = false;
+
+	if(!heldWeights.empty()) {
+		Event *next = heldWeights.front();
+		heldWeights.pop();
+		stageShadow(next);
 	}
+}
 
-	diagonals(index_counter);
-	transfer_matrix = xt::linalg::tensordot(mesh_layer, transfer_matrix, 1);
+/**
+* @brief take over the staged phases and rebuild the full matrix from the first stage that changed
+*/
+void clementsSVD::updateWeights() {
+
+	const uint32_t firstStage = firstChangedStage();
+
+	std::swap(phasesU, nextU);
+	std::swap(phasesS, nextS);
+	std::swap(phasesV, nextV);
 
+	if(propagationMode == PropagationMode::Layered && firstStage != numStages()) //the layered mode works on the rotations of the phases directly
+		updateRotations();
+	if(propagationMode != PropagationMode::Matrix || firstStage == numStages())
+		return;
+
+	if(precision == Precision::Single)
+		updateFullMatrix<float>(firstStage);
+	else
+		updateFullMatrix<double>(firstStage);
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
+* @brief update the full matrix with the scalar type T from the cache or by rebuilding the stages from firstStage on
 */
-xt::xarray<std::complex<double>> clementsSVD::dc_coupler(int32_t start) {
+template <typename T>
+void clementsSVD::updateFullMatrix(uint32_t firstStage) {
+
+	MeshBuffers<T> &mesh = buffers<T>();
+	if(mesh.matrixCache.enabled()) { //weight sets that were programmed before are copied from the cache
+
+		cacheKey.resize(2 * size * size + size);
+		std::copy(phasesV.begin(), phasesV.end(), cacheKey.begin());
+		std::copy(phasesS.begin(), phasesS.end(), cacheKey.begin() + size * size);
+		std::copy(phasesU.begin(), phasesU.end(), cacheKey.begin() + size * size + size);
+
+		if(const std::complex<T>* cached = mesh.matrixCache.find(cacheKey.data(), cacheKey.size())) {
+			std::copy(cached, cached + size * size, mesh.full_matrix.data());
+			if(matrixCheckpoint) //the checkpoint belongs to the previous phases
+				mesh.checkpoint = xt::eye<std::complex<T>>(size);
+			checkpointStage = 0;
+			cacheHits->addData(1);
+			return;
+		}
+		cacheMisses->addData(1);
+	}
+
+	reconstructFullMatrix<T>(firstStage);
+
+	if(mesh.matrixCache.enabled())
+		mesh.matrixCache.insert(cacheKey.data(), cacheKey.size(), mesh.full_matrix.data(), size * size);
+}
 
-	xt::xarray<std::complex<double>> out = xt::eye(size);
+/**
+* @brief e^{j phi} of the current phases of U and V in the precisions in use, so the layered mode does not evaluate cos and sin per event
+*/
+void clementsSVD::updateRotations() {
 
-	for(int i = start; i < size - 1; i +=2 ) {
-		xt::view(out, xt::range(i,i+2), xt::range(i,i+2)) = beam_splitter_matrix;
+	if(!buffersDouble.rotationsU.empty()) {
+		ClementsKernels::phaseRotations(phasesU.data(), size, buffersDouble.rotationsU.data());
+		ClementsKernels::phaseRotations(phasesV.data(), size, buffersDouble.rotationsV.data());
 	}
+	if(!buffersSingle.rotationsU.empty()) {
+		ClementsKernels::phaseRotations(phasesU.data(), size, buffersSingle.rotationsU.data());
+		ClementsKernels::phaseRotations(phasesV.data(), size, buffersSingle.rotationsV.data());
+	}
+}
 
-	return out; 
+/**
+* @brief first stage whose phases differ between the staged and the current weights, numStages() if nothing changed
+* @details see ClementsKernels::numSVDStages for the order of the stages
+*/
+uint32_t clementsSVD::firstChangedStage() {
+
+	for(uint32_t i = 0; i < size * size; i++)
+		if(nextV(i) != phasesV(i))
+			return ClementsKernels::columnOfPhase(size, i);
+
+	for(uint32_t i = 0; i < size; i++)
+		if(nextS(i) != phasesS(i))
+			return size + 1;
+
+	for(uint32_t i = 0; i < size * size; i++)
+		if(nextU(i) != phasesU(i))
+			return size + 2 + ClementsKernels::columnOfPhase(size, i);
+
+	return numStages();
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
+* @brief reconstruct the full matrix U * S * V from the current phases in the configured precision
 */
-void clementsSVD::phase_shifter(int32_t start, int32_t start_index, double multiplier = 1.0) {
+void clementsSVD::reconstructFullMatrix(uint32_t firstStage) {
 
-	mesh_layer = xt::eye(size);
-	int32_t counter = start_index;
+	if(precision == Precision::Single)
+		reconstructFullMatrix<float>(firstStage);
+	else
+		reconstructFullMatrix<double>(firstStage);
+}
 
-	for(int i = start; i < size - 1; i +=2 ) {
-		mesh_layer(i, i) = exp(phases(counter) * multiplier * jj);
-		counter++;
+/**
+* @brief reconstruct the full matrix U * S * V with the scalar type T
+* @details the stages are applied as 2x2 row rotations on the identity (see ClementsKernels::reconstructSVD).
+* The product of the stages before firstStage is kept as checkpoint, so an update that only touches
+* later stages (e.g. only S and U, or the last columns of U) restarts from the checkpoint instead of the identity.
+* Without matrixCheckpoint only the full matrix is stored and every update rebuilds all stages.
+* The columns of the matrices are independent, with numThreads > 1 every OpenMP thread rebuilds one block of columns
+* of both U and V. The threads only write to their own columns, so no locking is needed, also when SST runs several threads.
+* @param firstStage first stage that changed since the last reconstruction
+*/
+template <typename T>
+void clementsSVD::reconstructFullMatrix(uint32_t firstStage) {
+
+	MeshBuffers<T> &mesh = buffers<T>();
+	if(!matrixCheckpoint)
+		firstStage = 0;
+	else if(firstStage < checkpointStage) { //the checkpoint contains changed stages
+		mesh.checkpoint = xt::eye<std::complex<T>>(size);
+		checkpointStage = 0;
 	}
+
+	ClementsKernels::reconstructSVD(mesh.full_matrix.data(), matrixCheckpoint ? mesh.checkpoint.data() : nullptr, size,
+									phasesU.data(), phasesS.data(), phasesV.data(), checkpointStage, firstStage, numThreads);
+	checkpointStage = firstStage;
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
+* @brief propagate a batch through the mesh
+* @details the field is computed in the buffer of the input event and the per-instance workspace,
+* which only grows until it holds the largest batch, so a warm handler does not allocate
 */
-void clementsSVD::diagonals(int32_t start_index) {
+void clementsSVD::handleSelf(Event *ev) {
+
+	ComplexEvent *input = static_cast<ComplexEvent *>(ev);
+	while(shadowPending && input->getId() >= shadowFirstVector) { //first data vector of the new weight set
+
+		const SimTime_t currentTime = getCurrentSimTime(picoTimeConverter);
+		if(shadowReadyTime > currentTime) { //the set was held back behind the previous one and is still being programmed
+			selfLink->send(shadowReadyTime - currentTime, picoTimeConverter, input);
+			return;
+		}
+		swapShadow();
+	}
 
-	mesh_layer = xt::eye(size);
+	if (propagationMode == PropagationMode::Matrix && input->isSinglePrecision() != (precision == Precision::Single)) { //init() only sees the data of components that send init data, e.g. not of an upstream mesh
+		outputStr.fatal(
+			CALL_INFO, -1, 
+			"Error in %s: Data received at input port has %s precision, while the full matrix has %s precision. Please make sure that the \"precision\" parameter of connected components is identical \n", 
+			getName().c_str(), input->isSinglePrecision() ? "single" : "double", precision == Precision::Single ? "single" : "double");
+	}
 
-	for(int i = 0; i < size; i++)
-		mesh_layer(i,i) = exp(phases(start_index + i) * jj);
+	if(input->isSinglePrecision())
+		propagateBatch<float>(input);
+	else
+		propagateBatch<double>(input);
+
+	delete input;
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
+* @brief propagate a batch with the field type T (double or float) through the mesh
+* @details the layered mode works with either precision, the matrix mode multiplies with the full matrix
+* of the configured precision, handleSelf() checks that the data has the same precision
 */
-void clementsSVD::reconstructDiagonalMatrix() {
-
-	mesh_layer = xt::eye(size);
+template <typename T>
+void clementsSVD::propagateBatch(ComplexEvent *input) {
+
+	MeshBuffers<T> &mesh = buffers<T>();
+	std::vector<T> &workspace = mesh.workspace;
+	uint32_t batchSize = input->getBatchSize();
+	// the interleaved field of the input event is adapted in place and reused for the output event
+	Payload<T> buffer = input->releaseField<T>();
+	growWorkspace(workspace, buffer.size());
+	if(propagationMode == PropagationMode::Layered && mesh.rotationsU.empty()) { //first batch with the precision that was not configured
+
+		mesh.rotationsU.resize(2 * size * size);
+		mesh.rotationsV.resize(2 * size * size);
+		ClementsKernels::phaseRotations(phasesU.data(), size, mesh.rotationsU.data());
+		ClementsKernels::phaseRotations(phasesV.data(), size, mesh.rotationsV.data());
+	}
+	{
+		AllocationScope scope(selfAllocations);
+		std::complex<T>* field = reinterpret_cast<std::complex<T>*>(buffer.data());
+		std::complex<T>* work = reinterpret_cast<std::complex<T>*>(workspace.data());
+
+		if(propagationMode == PropagationMode::Layered) //y = U * S * V * x, V is passed first
+			ClementsKernels::propagateBatchSVD(mesh.kernels, field, work, size, batchSize, mesh.rotationsU.data(), phasesS.data(), mesh.rotationsV.data());
+		else { //all vectors of the batch in one GEMM, one row per vector, TODO add optical loss!!!
+
+			if(mesh.kernels.multiply) //fixed-size kernel of a small mesh instead of the BLAS call
+				mesh.kernels.multiply(field, mesh.full_matrix.data(), work, batchSize);
+			else {
+
+				auto signal = xt::adapt(field, batchSize * size, xt::no_ownership(), std::array<std::size_t, 2>{batchSize, size});
+				auto product = xt::adapt(work, batchSize * size, xt::no_ownership(), std::array<std::size_t, 2>{batchSize, size});
+				xt::blas::gemm(signal, mesh.full_matrix, product, false, true);
+			}
+			ClementsKernels::takeProduct(buffer, workspace); //the product is sent, the input buffer becomes the next workspace
+		}
+	}
 
-	for(int i = 0; i < size; i++)
-		mesh_layer(i,i) = phases(i);
+    ComplexEvent* output = new ComplexEvent(input->getId(), 3.0, std::move(buffer), batchSize);
+	outputLink->send(output);
 }
 
 /**
@@ -307,6 +639,8 @@ void clementsSVD::updateEnergy() {
 	SimTime_t currentTime = getCurrentSimTime(picoTimeConverter);
 	SimTime_t elapsedTime = currentTime - lastSwitch;
 	energyConsumption->addData(elapsedTime * modulator->staticModulatorPower + modulator->switchingEnergy);
+	if(inputWeightDigitalLink) //the fused DAC holds the weights like the DAC component
+		dacEnergyConsumption->addData(elapsedTime / dacClockPeriod * dacCurrentEnergy);
 
 	lastSwitch = currentTime;
 }
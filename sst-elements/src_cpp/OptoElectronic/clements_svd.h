@@ -4,12 +4,18 @@
 #include "../Events/complex_event.h"
 #include "../Events/analog_event.h"
 #include "Submodules/modulators.h"
+#include "../Kernels/clements_kernels.h"
+#include "../Kernels/matrix_cache.h"
+#include "../Kernels/allocation_counter.h"
+#include "../Kernels/dac_kernels.h"
+#include "../Events/digital_event.h"
 
 #include <sst/core/component.h>
 #include <sst/core/link.h>
 #include <sst/core/unitAlgebra.h>
 
 #include <complex>
+#include <queue>
 #include <cmath>
 #include <util.h>
 
@@ -43,16 +49,36 @@ class clementsSVD : public SST::Component {
 		{"verbose", 		"(uint32) level of debuggin output", "0"},
 		{"opticalLoss", 	"(double) total optical intensity loss of the mesh in percentage", "0"},
 		{"maxVin", 			"(double) maximal input voltage for the phase shifters in V", "0"},
+		{"propagationMode", "(string) matrix: multiply data with the dense transfer matrix, layered: propagate data through the MZI columns without building the matrix", "matrix"},
+		{"matrixCacheEntries","(uint32) max. number of transfer matrices kept in the LRU cache of reconstructed matrices, 0 for no limit. The cache is disabled if matrixCacheEntries and matrixCacheBytes are 0", "0"},
+		{"matrixCacheBytes", "(uint64) max. size of the LRU cache of reconstructed matrices in bytes (phases and matrix of each entry), 0 for no limit", "0"},
+		{"matrixCheckpoint", "(bool) keep the product of the stages before the first changed stage, so a weight update only rebuilds the changed stages. Costs a second size x size complex matrix per mesh, so it is off by default. Worth enabling if weight updates often only change S and U, false always rebuilds the full matrix from the identity", "false"},
+		{"numThreads", 		"(uint32) number of OpenMP threads used for rebuilding the transfer matrix after a weight update, 1 rebuilds it on the calling thread", "1"},
+		{"programmingLatency","(uint32) time in ps for programming a weight set received during the simulation into the shadow buffer of the mesh", "0"},
+		{"precision", 		"(string) double or single: scalar type of the full matrix and its checkpoint. Matrix mode expects data of the same precision, layered mode follows the precision of the data (the phase rotations of the other precision are only stored once such data arrives)", "double"},
+		{"dacType", 		"(string) architecture of the fused weight DAC C2C/R2R/CUSTOM, only used if inputWeightDigital is connected", "R2R"},
+		{"dacResolution", 	"(uint32) bit resolution of the fused weight DAC", "8"},
+		{"dacMinVout", 		"(double) min. voltage level of the fused weight DAC", "0"},
+		{"dacMaxVout", 		"(double) max. voltage level of the fused weight DAC", "1"},
+		{"dacElement", 		"(double) unit resistance or capacitance of the fused weight DAC", "5e3 (R2R)/1e-12 (C2C)"},
+		{"dacFrequency",	"(string) conversion frequency of the fused weight DAC (with unit)", "1GHz"},
+		{"dacControllerEnergy","(double) static controller energy usage per convert of the fused weight DAC in pJ", "1"},
+		{"dacEnergyCacheDir","(string) directory for caching the pre-computed energy per state of the fused weight DAC across runs, empty to only share the tables within a run", ""},
+		{"dacEnergyPerValue","(vector<double>) energy consumption per state of the fused weight DAC in pJ. Only used for dacType=custom", "1"},
 	);
 
 	SST_ELI_DOCUMENT_PORTS(
-		{"inputData", 		"receiving input signal (complex)", {"sst.byod.complexEvent"}},
+		{"inputData", 		"receiving input signal (complex), single or batched vectors", {"sst.byod.complexEvent"}},
 		{"inputWeight", 	"receiving weight input signal (analog)", {"sst.byod.analogEvent"}},
-		{"output", 			"sending output signal (complex)", {"sst.byod.complexEvent"}}
+		{"inputWeightDigital","receiving weight input signal as DAC codes (digital), replaces the weight DAC and inputWeight", {"sst.byod.digitalEvent"}},
+		{"output", 			"sending output signal (complex), same batch size as the input", {"sst.byod.complexEvent"}}
 	);
 
 	SST_ELI_DOCUMENT_STATISTICS(
-		{"energyMesh", 		"Cumulative energy consumption of the optical mesh and the optical modulators", "pJ", 1}
+		{"energyMesh", 		"Cumulative energy consumption of the optical mesh and the optical modulators", "pJ", 1},
+		{"energyDAC", 		"Cumulative energy consumption of the fused weight DAC", "pJ", 1},
+		{"matrixCacheHits", "Number of weight updates whose transfer matrix was found in the matrix cache", "count", 1},
+		{"matrixCacheMisses","Number of weight updates whose transfer matrix was reconstructed and added to the matrix cache", "count", 1}
 	);
 
 	SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS(
@@ -60,7 +86,7 @@ class clementsSVD : public SST::Component {
 	);
 
 	clementsSVD(ComponentId_t id, Params &params);
-	~clementsSVD() {};
+	~clementsSVD();
 
 	void setup();
 	void finish();
@@ -68,19 +94,27 @@ class clementsSVD : public SST::Component {
 
 	void handleDataInput(Event *ev);
 	void handleWeightInput(Event *ev);
+	void handleDigitalWeightInput(Event *ev);
+	void checkWeights(const AnalogEvent &input);
+	void checkWeights(const DigitalEvent &input);
+	void holdWeights(Event *ev, uint32_t firstVector);
+	void stageShadow(Event *ev);
+	void stageWeightCodes(const DigitalEvent &input);
+	void stageWeightVoltages(const Payload<double> &voltages);
+	void beginShadowUpdate(uint32_t firstVector);
+	void endShadowUpdate();
+	void swapShadow();
 	void handleSelf(Event *ev);
-	void reconstructUnitaryMatrix();
-	void reconstructFullMatrix();
+	template <typename T> void propagateBatch(ComplexEvent *input);
+	void updateWeights();
+	void updateRotations();
+	template <typename T> void updateFullMatrix(uint32_t firstStage);
+	uint32_t firstChangedStage();
+	uint32_t numStages() const { return ClementsKernels::numSVDStages(size); } //V columns, V output phases, S, U columns, U output phases
+	void reconstructFullMatrix(uint32_t firstStage = 0);
+	template <typename T> void reconstructFullMatrix(uint32_t firstStage);
 	void updateEnergy();
 
-	//functions for reconstructing a matrix from a set of phases
-	void U2MZI(int32_t row, double theta, double phi);
-	void diagonals(xt::xarray<std::complex<double>> phases);
-	xt::xarray<std::complex<double>> dc_coupler(int32_t start);
-	void phase_shifter(int32_t start, int32_t start_index, double multiplier);
-	void diagonals(int32_t start_index);
-	void reconstructDiagonalMatrix();
-
   private:
 	/** IO *****************************************************/
 
@@ -90,6 +124,7 @@ class clementsSVD : public SST::Component {
 
 	Link *inputDataLink;
 	Link *inputWeightLink;
+	Link *inputWeightDigitalLink;
 	Link *outputLink;
 	Link *selfLink;
 
@@ -97,13 +132,28 @@ class clementsSVD : public SST::Component {
 
 	uint32_t size;
 	uint32_t latency;
+	uint32_t programmingLatency;
+	uint32_t numThreads;
+	bool matrixCheckpoint;
 	uint32_t verbose;
 	double opticalLoss;
 	double maxVin;
+	PropagationMode propagationMode;
+	Precision precision;
+	DACType dacType;
+	uint32_t dacResolution;
+	double dacMinVout;
+	double dacMaxVout;
+	double dacElement;
+	double dacControllerEnergy;
+	UnitAlgebra dacFrequency;
 
 	/** Statistics *********************************************/
 
 	Statistic<double_t> *energyConsumption;
+	Statistic<double_t> *dacEnergyConsumption;
+	Statistic<uint64_t> *cacheHits;
+	Statistic<uint64_t> *cacheMisses;
 
 	/** operation *********************************************/
 
@@ -111,22 +161,50 @@ class clementsSVD : public SST::Component {
 	SimTime_t lastSwitch;
 	TimeConverter *nanoTimeConverter;
 	TimeConverter *picoTimeConverter;
-
-	std::vector<double> test_data;
-	xt::xarray<std::complex<double>> transfer_matrix;
-	xt::xarray<std::complex<double>> full_matrix;
-	xt::xarray<std::complex<double>> mesh_layer;
-	xt::xarray<double> phases;
+	DACKernels::EnergyTable dacEnergyPerValue; //read-only, shared with all DACs with the same parameters
+	double dacCurrentEnergy;
+	double dacClockPeriod;
+
+	/**
+	* @brief buffers and kernels of the mesh whose scalar type depends on the precision, only the set of the configured precision holds matrices
+	*/
+	template <typename T>
+	struct MeshBuffers {
+		ClementsKernels::MeshKernels<T> kernels; //fixed-size kernels, nullptr for sizes other than 4, 8 and 16
+		std::vector<T> rotationsU; //e^{j phi} of the phases of U and V, only used in layered mode
+		std::vector<T> rotationsV;
+		xt::xarray<std::complex<T>> full_matrix;
+		xt::xarray<std::complex<T>> checkpoint; //product of the stages before checkpointStage
+		TransferMatrixCache<T> matrixCache; //full matrices of previous weight sets
+		Payload<T> workspace; //interleaved field of one batch, swapped with the buffer of the input event after a GEMM
+	};
+
+	template <typename T>
+	MeshBuffers<T>& buffers() {
+		if constexpr (std::is_same<T, float>::value)
+			return buffersSingle;
+		else
+			return buffersDouble;
+	}
+
+	MeshBuffers<double> buffersDouble;
+	MeshBuffers<float> buffersSingle;
 	xt::xarray<double> phasesU;
 	xt::xarray<double> phasesS;
 	xt::xarray<double> phasesV;
-	xt::xarray<std::complex<double>> odd_dc_couplers;
-	xt::xarray<std::complex<double>> even_dc_couplers;
-
-	const std::complex<double> jj = std::complex<double>(0.0, 1.0);
-	const xt::xarray<std::complex<double>> beam_splitter_matrix
-      {{1 / sqrt(2.0), 1 / sqrt(2.0) * jj},
-       {1 / sqrt(2.0) * jj, 1 / sqrt(2.0)}};
+	xt::xarray<double> nextU; //staging buffers of the next weight update, shadow buffers for weights received during the simulation
+	xt::xarray<double> nextS;
+	xt::xarray<double> nextV;
+	bool shadowPending; //the shadow buffers hold a weight set that has not been swapped in yet
+	std::queue<Event *> heldWeights; //weight sets received while shadowPending, programmed in order of arrival after each swap
+	uint32_t shadowFirstVector; //id of the first data vector computed with the shadow weights
+	SimTime_t shadowReadyTime; //time in ps when programming the shadow weights is complete
+	double activeModulatorPower; //static power of the modulators while the shadow weights are programmed
+	double shadowModulatorPower;
+	uint32_t checkpointStage;
+	std::vector<double> cacheKey; //phases of V, S and U in one buffer
+	std::vector<uint64_t> weightCodes; //codes of a digital weight set, unpacked for the modulator
+	AllocationCheck selfAllocations{"clementsSVD::handleSelf"};
 };
 } // namespace BYOD
 } // namespace SST
@@ -41,39 +41,49 @@ DAC::DAC(ComponentId_t id, Params &params) : Component(id) {
 	maxVout = 			params.find<double>("maxVout", 1.0);
 	controllerEnergy = 	params.find<double>("controllerEnergy", 1);
 	frequency = 		params.find<UnitAlgebra>("frequency", "1GHz");
+	inputQueueDepth = 	std::max(params.find<uint32_t>("inputQueueDepth", 1), uint32_t(1));
 
 	inputlink = 		configureLink("input",	new Event::Handler<DAC>(this, &DAC::handleInput));
 	outputlink = 		configureLink("output");
 	selflink = 			configureSelfLink("selflink", new Event::Handler<DAC>(this, &DAC::handleSelf));
+	creditlink = 		configureLink("creditOutput");
 	energyConsumption = registerStatistic<double_t>("energyDAC");
+	queueOccupancy = 	registerStatistic<uint32_t>("queueOccupancy");
+	stallCycles = 		registerStatistic<uint64_t>("stallCycles");
+	droppedEvents = 	registerStatistic<uint64_t>("droppedEvents");
 
 	std::string prefix = "@t\t@X\t[DAC::" + std::to_string(id) + "]:\t";
 	outputStr.init(prefix, verbose, 0, SST::Output::STDOUT);
 	
-	registerClock(frequency, new Clock::Handler<DAC>(this, &DAC::clockTick));
+	clockHandler = 		new Clock::Handler<DAC>(this, &DAC::clockTick);
+	clockTC = 			registerClock(frequency, clockHandler);
 	glockPeriod = 1 / frequency.getDoubleValue() * 1e12;
 
-	params.find_array("energyPerValue", energyPerValue);
+	if(dacType == DACType::CUSTOM) { //use and check user-provided energyPerValue
 
-	if (dacType == DACType::R2R) //set conductance for R2R ladder cells
-		element = 1 / element / 2;
-	if(dacType == DACType::CUSTOM && energyPerValue.size() != std::pow(2, resolution)) { //use and check user-provided energyPerValue
+		std::vector<double> customEnergy;
+		params.find_array("energyPerValue", customEnergy);
+		if(customEnergy.size() != std::pow(2, resolution)) {
 
-		outputStr.output(
-			CALL_INFO, 
-			"Warning in %s: Size of energyPerValue is %lu, while the internal size is %f. EnergyPerValue will be set to zero \n", 
-			getName().c_str(), energyPerValue.size(), std::pow(2, resolution));
-		energyPerValue = std::vector<double>(std::pow(2, resolution), 0.0);
+			outputStr.output(
+				CALL_INFO, 
+				"Warning in %s: Size of energyPerValue is %lu, while the internal size is %f. EnergyPerValue will be set to zero \n", 
+				getName().c_str(), customEnergy.size(), std::pow(2, resolution));
+			customEnergy = std::vector<double>(std::pow(2, resolution), 0.0);
+		}
+		energyPerValue = std::make_shared<const std::vector<double>>(std::move(customEnergy));
 	}
-	else if(dacType !=  DACType::CUSTOM) //pre-compute the energy per Value for R2R and C2C DAC
-		precomputeEnergy();	
+	else //pre-computed energy per Value for R2R and C2C DAC, shared with identical DACs
+		energyPerValue = DACKernels::sharedEnergyPerValue(dacType, resolution, element, maxVout, glockPeriod, params.find<std::string>("energyCacheDir", ""));
 
 
 
 	nanoTimeConverter = getTimeConverter("1ns");
 	picoTimeConverter = getTimeConverter("1ps");
 
-	inputEvent = NULL;
+	busyUntil = 0;
+	clockSuspended = false;
+	lastCycle = 0;
 	lastSwitch = 0;
 }
 
@@ -85,6 +95,9 @@ void DAC::setup() { }
 */
 void DAC::init(unsigned int phase){
 
+	if(phase == 0 && creditlink) //the upstream component may send as many events as the queue can hold
+		creditlink->sendUntimedData(new CreditEvent(inputQueueDepth));
+
     // Check if an event is received. recvUntimedData returns nullptr if no event is available
     while (SST::Event* ev = inputlink->recvUntimedData()) {
 
@@ -102,17 +115,19 @@ void DAC::init(unsigned int phase){
 				"Error in %s: Data received at input port has a resolution of %u, while the expected resolution is %u. Please make sure that the resolution of connected components is identical to the \"resolution\" parameter \n", 
 				getName().c_str(), event->getResolution(), resolution);
 		}
-		if (event->getData().size() != size) { //check for correct size of input vector
+		if (event->getSize() != size) { //check for correct size of input vector
 			outputStr.fatal(
 				CALL_INFO, -1, 
 				"Error in %s: Data received at input port has a size of %u, while the expected size is %u. Please make sure that size of connected components is identical to the \"size\" parameter \n", 
-				getName().c_str(), int(event->getData().size()), size);
+				getName().c_str(), int(event->getSize()), size);
 		}
 		if(event) {
-			xt::xarray<double> voltages_inp = xt::adapt(event->getData(), {size});
-			auto voltages_out = this->convert(voltages_inp);
-			currentEnergy = currentForConversion(voltages_inp) + controllerEnergy * size;
-			outputlink->sendUntimedData(new AnalogEvent(event->getId(), maxVout, xarray2vector<double>(voltages_out)));
+			Payload<double> voltages(event->getSize());
+			event->visitCodes([&](const auto* codes, size_t n) {
+				convert(codes, voltages.data(), n);
+				currentEnergy = currentForConversion(codes, n) + controllerEnergy * size;
+			});
+			outputlink->sendUntimedData(new AnalogEvent(event->getId(), maxVout, std::move(voltages)));
 		}
 	}
 }
@@ -121,6 +136,12 @@ void DAC::init(unsigned int phase){
 void DAC::finish() {
 
 	updateEnergy();
+
+	if (clockSuspended) { //the cycles after the last clock tick had an empty queue, the occupancy has one sample per cycle like with an always-on clock
+		const Cycle_t currentCycle = getCurrentSimTime(clockTC);
+		if (currentCycle > lastCycle)
+			queueOccupancy->addDataNTimes(currentCycle - lastCycle, 0);
+	}
 }
 
 /**
@@ -129,52 +150,83 @@ void DAC::finish() {
 */
 bool DAC::clockTick(Cycle_t cycle) {
 
-	if (inputEvent != NULL) {
-		selflink->send(latency, picoTimeConverter, inputEvent);
-		inputEvent = NULL;
+	queueOccupancy->addData(inputQueue.size());
+	lastCycle = cycle;
+
+	if (inputQueue.empty()) { //nothing to convert, suspend the clock until the next input event
+		clockSuspended = true;
+		return true;
+	}
+	if (cycle < busyUntil) { //the previous batch is still being converted
+		stallCycles->addData(1);
+		return false;
 	}
+
+	Event *inputEvent = inputQueue.front();
+	inputQueue.pop();
+
+	// a batch of vectors is converted one vector per clock cycle
+	uint32_t batchSize = static_cast<DigitalEvent *>(inputEvent)->getBatchSize();
+	busyUntil = cycle + batchSize;
+	selflink->send(latency + SimTime_t((batchSize - 1) * glockPeriod), picoTimeConverter, inputEvent);
+
+	if (creditlink)
+		creditlink->send(new CreditEvent(1));
 	return false;
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
+* @brief queue an incoming event until the DAC is free, events arriving at a full queue are dropped
 */
 void DAC::handleInput(Event *ev) {
 
-	delete inputEvent;
-	inputEvent = ev;
+	if (inputQueue.size() >= inputQueueDepth) {
+		outputStr.verbose(CALL_INFO, 1, 0, "input queue full, event %u dropped\n", static_cast<DigitalEvent *>(ev)->getId());
+		droppedEvents->addData(1);
+		delete ev;
+		return;
+	}
+	inputQueue.push(ev);
+
+	if (clockSuspended) { //re-arm the clock at the next clock edge, the skipped cycles had an empty queue
+		Cycle_t nextCycle = reregisterClock(clockTC, clockHandler);
+		queueOccupancy->addDataNTimes(nextCycle - lastCycle - 1, 0);
+		clockSuspended = false;
+	}
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
+* @brief convert a batch of codes, the codes are read directly from the input event
+* @details the payload of the output event is taken from the payload pool, the codes return to the pool with the input event
 */
 void DAC::handleSelf(Event *ev) {
 
 	DigitalEvent *input = static_cast<DigitalEvent *>(ev);
-	xt::xarray<double> voltages_inp = xt::adapt(input->getData(), {size});
+	uint32_t batchSize = input->getBatchSize();
+	Payload<double> voltages;
 
 	updateEnergy();
-	currentEnergy = currentForConversion(voltages_inp) + controllerEnergy * size;
-
-	auto voltages_out = this->convert(voltages_inp);
+	{
+		AllocationScope scope(selfAllocations);
+		voltages = PayloadPool<double>::acquire(input->getSize());
+		input->visitCodes([&](const auto* codes, size_t n) { //the loops are compiled for the packed word type
+			currentEnergy = currentForConversion(codes, n) / batchSize + controllerEnergy * size; //average energy per conversion of the batch
+			convert(codes, voltages.data(), n);
+		});
+	}
 
-	outputlink->send(new AnalogEvent(input->getId(), 0, xarray2vector<double>(voltages_out)));
+	outputlink->send(new AnalogEvent(input->getId(), 0, std::move(voltages), batchSize));
 
 	delete input;
 }
 
 /**
-* @brief BRIEF.
-* @details DETAILS
+* @brief output voltages of n codes
 */
-xt::xarray<double> DAC::convert(xt::xarray<double> input) {
-
-	//std::cout << "adlevls" << input << std::endl;
+template <typename T>
+void DAC::convert(const T* codes, double* voltages, size_t n) {
 
-	input = (maxVout - minVout) / (std::pow(2, resolution) - 1) * input;
-	return input;
+	DACKernels::codesToVoltages(codes, voltages, n, DACKernels::voltageStep(minVout, maxVout, resolution));
 }
 
 /**
@@ -194,87 +246,15 @@ void DAC::updateEnergy() {
 * @brief BRIEF.
 * @details DETAILS
 */
-double_t DAC::currentForConversion(xt::xarray<int32_t> value) {
+template <typename T>
+double_t DAC::currentForConversion(const T* codes, size_t n) {
 
+	const std::vector<double> &energy = *energyPerValue;
 	double_t out = 0.0;
-	for (size_t i = 0; i < size; ++i) 
-		out += energyPerValue[value(i)];
+	for (size_t i = 0; i < n; ++i) 
+		out += energy[codes[i]];
 	
 	return out;
 }
-
-/**
-* @brief BRIEF.
-* @details DETAILS
-*/
-double_t DAC::convertEnergy(int32_t inp) {
-
-	xt::xarray<int8_t> inp_bits = value2bits(inp);
-	xt::xarray<double_t> node_voltages = voltagesAtEachNode(inp_bits * maxVout);
-	if (dacType == DACType::C2C)
-		return xt::sum((maxVout - node_voltages) * xt::flip(inp_bits, 0))[0] * maxVout * element;
-	else
-		return xt::sum((maxVout - node_voltages) * xt::flip(inp_bits, 0))[0] * maxVout * element * glockPeriod;
-}
-
-/**
-* @brief BRIEF.
-* @details DETAILS
-*/
-xt::xarray<double_t> DAC::voltagesAtEachNode(xt::xarray<int8_t> inp) {
-	return xt::flip(xt::linalg::dot(conversionNodeMatrix, inp), 0);
-}
-
-/**
-* @brief BRIEF.
-* @details DETAILS
-*/
-xt::xarray<int8_t> DAC::value2bits(int32_t x) {
-	if (x > pow(2, resolution) - 1) {
-		outputStr.fatal(CALL_INFO, -1,
-					 "%d is too large to be represented by binary "
-					 "representation with the given bit resolution %u",
-					 x, resolution);
-		throw std::invalid_argument(
-			"x is too large to be represented by binary representation with "
-			"the given number of bits\n");
-	}
-
-	xt::xarray<int8_t> bits = xt::zeros<int8_t>({resolution});
-
-	for (std::size_t i = 0; i < resolution; ++i) {
-		bits(i) = x % 2;
-		x /= 2;
-	}
-
-	return bits;
-}
-
-/**
-* @brief BRIEF.
-* @details DETAILS
-*/
-void DAC::precomputeEnergy() {
-	// build initial matrix for conversion nodes
-	xt::xarray<double_t> M = xt::zeros<double_t>({resolution, resolution});
-	M(0, 0) = 4;
-	M(0, 1) = -2;
-
-	for (size_t i = 1; i < resolution - 1; ++i) {
-		M(i, i - 1) = -2;
-		M(i, i) = 5;
-		M(i, i + 1) = -2;
-	}
-
-	M(resolution - 1, resolution - 2) = -2;
-	M(resolution - 1, resolution - 1) = 3;
-	// inverse
-	conversionNodeMatrix = xt::linalg::inv(M);
-
-	energyPerValue = std::vector<double>(std::pow(2, resolution), 0.0);
-	for(int i = 0; i < energyPerValue.size(); i++) {
-		energyPerValue[i] = convertEnergy(i);
-	}
-}
 } // namespace BYOD
 } // namespace SST
\ No newline at end of file
@@ -3,8 +3,12 @@
 
 #include "../Events/digital_event.h"
 #include "../Events/analog_event.h"
+#include "../Events/credit_event.h"
+#include "../Kernels/dac_kernels.h"
+#include "../Kernels/allocation_counter.h"
 
 #include <cstdint>
+#include <queue>
 #include <math.h>
 #include <util.h>
 
@@ -22,26 +26,6 @@
 namespace SST {
 namespace BYOD {
 
-enum DACType { C2C, R2R, CUSTOM };
-
-/**
-* @brief BRIEF.
-* @details DETAILS
-*/
-DACType parseDACStr(std::string str) {
-	std::transform(str.begin(), str.end(), str.begin(),
-				   [](unsigned char c) { return std::tolower(c); });
-	if (str == "c2c") {
-		return DACType::C2C;
-	} else if (str == "r2r") {
-		return DACType::R2R;
-	} else if (str == "custom") {
-		return DACType::CUSTOM;
-	} else {
-		throw std::invalid_argument("DAC type %s not supported.\n");
-	}
-}
-
 /**
 * @brief BRIEF.
 * @details DETAILS
@@ -69,15 +53,21 @@ class DAC : public SST::Component {
 		{"frequency",		"(string) conversion frequency (with unit)", "1"},
 		{"controllerEnergy","(double) static controller energy usage per convert in pJ", "1"},
 		{"energyPerState",	"(vector<double>) array containing the energy consumption per DAC state in pJ. Only used for dacType=custom", "1"},
+		{"energyCacheDir",	"(string) directory for caching the pre-computed energy per DAC state across runs, empty to only share the tables within a run", ""},
+		{"inputQueueDepth",	"(uint32) number of input events buffered in front of the DAC, events arriving at a full queue are dropped", "1"},
 	);
 
 	SST_ELI_DOCUMENT_PORTS(
-		{"input", 			"receiving input signal (digital)", {"sst.byod.digitalEvent"}},
-		{"output", 			"sending output signal (analog)", {"sst.byod.analogEvent"}}
+		{"input", 			"receiving input signal (digital), single or batched vectors", {"sst.byod.digitalEvent"}},
+		{"output", 			"sending output signal (analog), same batch size as the input", {"sst.byod.analogEvent"}},
+		{"creditOutput", 	"optional, returns a credit to the upstream component whenever an event leaves the input queue", {"sst.byod.creditEvent"}}
 	);
 
 	SST_ELI_DOCUMENT_STATISTICS(
-		{"energyDAC", 		"Cumulative energy consumption of DAC", "pJ", 1}
+		{"energyDAC", 		"Cumulative energy consumption of DAC", "pJ", 1},
+		{"queueOccupancy", 	"Number of events in the input queue, sampled every clock cycle", "events", 1},
+		{"stallCycles", 	"Clock cycles in which events wait in the input queue while the DAC is busy", "cycles", 1},
+		{"droppedEvents", 	"Events dropped because the input queue was full", "events", 1}
 	);
 
 	DAC(ComponentId_t id, Params &params);
@@ -90,7 +80,7 @@ class DAC : public SST::Component {
 	bool clockTick(Cycle_t cycle);
 	void handleInput(Event *ev);
 	void handleSelf(Event *ev);
-	xt::xarray<double> convert(xt::xarray<double> input);
+	template <typename T> void convert(const T* codes, double* voltages, size_t n);
 	void updateEnergy();
 
 
@@ -104,6 +94,7 @@ class DAC : public SST::Component {
 	Link *inputlink;
 	Link *outputlink;
 	Link *selflink;
+	Link *creditlink;
 
 	/** Parameters ********************************************/
 
@@ -116,23 +107,31 @@ class DAC : public SST::Component {
 	double minVout;
 	double maxVout;
 	double controllerEnergy;
-	std::vector<double> energyPerValue;
+	DACKernels::EnergyTable energyPerValue; //read-only, shared by all DACs with the same parameters
+	uint32_t inputQueueDepth;
 
 	/** Statistics *********************************************/
 
 	Statistic<double> *energyConsumption;
+	Statistic<uint32_t> *queueOccupancy;
+	Statistic<uint64_t> *stallCycles;
+	Statistic<uint64_t> *droppedEvents;
 
 	/** operation *********************************************/
 
 	SimTime_t lastSwitch;
-	Event *inputEvent;
+	std::queue<Event *> inputQueue;
+	Cycle_t busyUntil; //first cycle in which the DAC can start the next conversion
+	TimeConverter *clockTC;
+	Clock::HandlerBase *clockHandler;
+	bool clockSuspended; //the clock is unregistered while the input queue is empty
+	Cycle_t lastCycle; //last cycle the clock handler was called
 	uint32_t verbose;
 	double currentEnergy;
 	double glockPeriod;
 	TimeConverter *nanoTimeConverter;
 	TimeConverter *picoTimeConverter;
-	// inverse of conversion node matrix
-	xt::xarray<double_t> conversionNodeMatrix;
+	AllocationCheck selfAllocations{"DAC::handleSelf"};
 
 
 	/**
@@ -141,40 +140,7 @@ class DAC : public SST::Component {
 	 * for one elements: v_max * count_ones_binary - v_out
 	 *
 	 */
-	double_t currentForConversion(xt::xarray<int32_t> value);
-
-	/**
-	 * @brief energy for converting given input value
-	 * @param inp integer input value
-	 * @returns energy for conversion
-	 */
-	double_t convertEnergy(int32_t inp);
-
-	/**
-	 * @brief get voltages for each of the bit_res nodes
-	 * @details DAC consists of bit_res nodes.
-	 * An input integer is converted to its binary representation.
-	 * Each bit_res node has an output voltage
-	 * The input->output equation can be represented by the Mx = y equation
-	 * [x_0]   [ 4  -2   0   0   0  ...]   [v_0]
-	 * [x_1]   [-2   5  -2   0   0  ...]   [v_1]
-	 * [x_2] = [ 0  -2   5  -2   0  ...] x [v_2]
-	 * [...]   [ ......................]   [...]
-	 * [x_n]   [ 0   0   0  ... -2   3 ]   [v_n]
-	 * which is solved by this method
-	 * @param inp input integer value
-	 * @returns output voltages for each bit
-	 */
-	xt::xarray<double_t> voltagesAtEachNode(xt::xarray<int8_t> inp);
-
-	void precomputeEnergy();
-
-	/**
-	 * @brief convert value to array of bits
-	 * @param x input integer value
-	 * @returns array of bits with LSB=out(0) LSB and MSB=out(bit_res)
-	 */
-	xt::xarray<int8_t> value2bits(int32_t x);
+	template <typename T> double_t currentForConversion(const T* codes, size_t n);
 };
 } // namespace BYOD
 } // namespace SST
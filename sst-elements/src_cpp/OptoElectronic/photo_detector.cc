@@ -78,17 +78,22 @@ void photoDetector::init(unsigned int phase){
 				"Error in %s: Expected input port to be connected to an Element with complex output. Please check that components connected to %s have the correct output type\n", 
 				getName().c_str(), getName().c_str());
         } 
-		if (event->getReal().size() != size) { //check for correct size of input vector
+		if (event->getSize() != size) { //check for correct size of input vector
 
 			outputStr.fatal(
 				CALL_INFO, -1, 
 				"Error in %s: Data received at input port has a size of %u, while the expected size is %u. Please make sure that size of connected components is identical to the \"size\" parameter \n", 
-				getName().c_str(), int(event->getReal().size()), size);
+				getName().c_str(), int(event->getSize()), size);
 		}
-		if(event) { //TODO!!!
+		if(event && event->isSinglePrecision()) { //TODO!!!
 
-			std::vector<double> signal_out(size, 0);
-			outputLink->sendUntimedData(new AnalogEvent(event->getId(), 1.0, signal_out));
+			Payload<float> signal_out(size, 0);
+			outputLink->sendUntimedData(new AnalogEvent(event->getId(), 1.0, std::move(signal_out)));
+		}
+		else if(event) {
+
+			Payload<double> signal_out(size, 0);
+			outputLink->sendUntimedData(new AnalogEvent(event->getId(), 1.0, std::move(signal_out)));
 		}
 	}
 }
@@ -118,24 +123,44 @@ void photoDetector::handleInput(Event *ev) {
 void photoDetector::handleSelf(Event *ev) {
 
 	ComplexEvent *input = static_cast<ComplexEvent *>(ev);
-	xt::xarray<std::complex<double>> signal = xt::adapt(input->getReal(),{size}) + jj * xt::adapt(input->getImag(),{size});
-
-	switch(pdType) {
-		case(DetectorMode::Single):
-			signal = tiaGain * sensitivity * xt::square(xt::abs(signal));
-			updateEnergy();
-			break;
-		default:
-			break;
-	}
+	if(input->isSinglePrecision()) //the output has the precision of the optical field
+		detect<float>(input);
+	else
+		detect<double>(input);
 
-	std::vector<double> signal_out(xt::real(signal).begin(), xt::real(signal).end()); 
-    AnalogEvent* output = new AnalogEvent(input->getId(), 3.0, signal_out); //TODO!!!
-	outputLink->send(output);
+	if(pdType == DetectorMode::Single)
+		updateEnergy();
 
 	delete input;
 }
 
+/**
+* @brief detect a batch with the field type T (double or float), the output voltages have the same type
+*/
+template <typename T>
+void photoDetector::detect(ComplexEvent *input) {
+
+	uint32_t batchSize = input->getBatchSize();
+	size_t n = input->getSize();
+	Payload<T> signal_out = input->releaseField<T>(); //the interleaved field (re, im, ...) is reused for the output event
+	// entry i is written after entries 2i and 2i+1 have been read, so the output can be built in place
+	{
+		AllocationScope scope(selfAllocations);
+		switch(pdType) {
+			case(DetectorMode::Single):
+				DetectorKernels::intensities(signal_out.data(), n, tiaGain * sensitivity); // |E|^2
+				break;
+			default:
+				DetectorKernels::realParts(signal_out.data(), n);
+				break;
+		}
+		signal_out.resize(n); //shrinking keeps the buffer
+	}
+
+    AnalogEvent* output = new AnalogEvent(input->getId(), 3.0, std::move(signal_out), batchSize); //TODO!!!
+	outputLink->send(output);
+}
+
 /**
 * @brief BRIEF.
 * @details DETAILS
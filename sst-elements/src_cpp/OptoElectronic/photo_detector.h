@@ -3,6 +3,8 @@
 
 #include "../Events/complex_event.h"
 #include "../Events/analog_event.h"
+#include "../Kernels/allocation_counter.h"
+#include "../Kernels/detector_kernels.h"
 
 #include <sst/core/component.h>
 #include <sst/core/link.h>
@@ -70,8 +72,8 @@ class photoDetector : public SST::Component {
 	);
 
 	SST_ELI_DOCUMENT_PORTS(
-		{"input", 				"receiving input signal (complex)", {"sst.byod.complexEvent"}},
-		{"output", 				"sending output signal (analog)", {"sst.byod.analogEvent"}}
+		{"input", 				"receiving input signal (complex), single or batched vectors", {"sst.byod.complexEvent"}},
+		{"output", 				"sending output signal (analog), same batch size as the input", {"sst.byod.analogEvent"}}
 	);
 
 	SST_ELI_DOCUMENT_STATISTICS(
@@ -87,6 +89,7 @@ class photoDetector : public SST::Component {
 
 	void handleInput(Event *ev);
 	void handleSelf(Event *ev);
+	template <typename T> void detect(ComplexEvent *input);
 	void updateEnergy();
 
   private:
@@ -122,8 +125,8 @@ class photoDetector : public SST::Component {
 	TimeConverter *nanoTimeConverter;
 	TimeConverter *picoTimeConverter;
 	SimTime_t lastSwitch;
+	AllocationCheck selfAllocations{"photoDetector::handleSelf"};
 	double currentPdPower;
-	const std::complex<double> jj = std::complex<double>(0.0, 1.0);
 };
 } // namespace BYOD
 } // namespace SST
@@ -68,8 +68,8 @@ void XXX::init(unsigned int phase){
 			output.fatal(CALL_INFO, -1, "Error in %s: Digital data received at input port has a resolution of %u bits, while the internal resolution is %u bits. Please make sure that the resolution of connected components is identical by setting the \"resolution\" parameter\n", getName().c_str(), event->getResolution(), resolution);
 			//output.fatal(CALL_INFO, -1, "Error in %s: Analog data received at input port has a vmax of %f V, while the internal vmax is %f V. Please make sure that vmax of connected components is identical by setting the \"max_vin/vout\" parameter\n", getName().c_str(), event->getResolution(), resolution);
 		}
-		if (event->getData().size() != size) { //check for correct size of input vector
-			output.fatal(CALL_INFO, -1, "Error in %s: Data received at input port has a size of %u, while the internal size is %u. Please make sure that size of connected components is identical by setting the \"size\" parameter \n", getName().c_str(), int(event->getData().size()), size);
+		if (event->getSize() != size) { //check for correct size of input vector
+			output.fatal(CALL_INFO, -1, "Error in %s: Data received at input port has a size of %u, while the internal size is %u. Please make sure that size of connected components is identical by setting the \"size\" parameter \n", getName().c_str(), int(event->getSize()), size);
 		}
 	}
 
@@ -3,18 +3,19 @@
 #define _UTIL_H
 
 #include <cstdint>
+#include <cstring>
 #include <iomanip>
 #include <vector>
 #include <xtensor/containers/xarray.hpp>
 
-template <typename T> std::vector<T> xarray2vector(xt::xarray<T> inp) {
+template <typename T> std::vector<T> xarray2vector(const xt::xarray<T> &inp) {
 	std::vector<T> dst(inp.size());
 	std::copy(inp.cbegin(), inp.cend(), dst.begin());
 
 	return dst;
 }
 
-template <typename T> std::vector<uint8_t> castToMemVector(std::vector<T> x) {
+template <typename T> std::vector<uint8_t> castToMemVector(const std::vector<T> &x) {
 	uint8_t bytes = sizeof(T) / sizeof(uint8_t);
 	std::vector<uint8_t> res(x.size() * sizeof(T));
 
@@ -29,7 +30,7 @@ template <typename T> std::vector<uint8_t> castToMemVector(std::vector<T> x) {
 	return res;
 }
 
-template <typename T> std::vector<T> castFromMemVector(std::vector<uint8_t> x) {
+template <typename T> std::vector<T> castFromMemVector(const std::vector<uint8_t> &x) {
 	uint8_t bytes = sizeof(T) / sizeof(uint8_t);
 	std::vector<T> res(x.size() / sizeof(T));
 	for (size_t i = 0; i < x.size(); ++i) {
@@ -40,6 +41,33 @@ template <typename T> std::vector<T> castFromMemVector(std::vector<uint8_t> x) {
 	return res;
 }
 
+/**
+* @brief unpack little-endian integers of bytesPerElement bytes (1 ... 8) from a byte stream
+* @details element i is made of the bytes [i * bytesPerElement, (i + 1) * bytesPerElement), lowest byte first.
+* This is the memory layout written by StreamingCPU.getBytesFromLevels in utils/byod_components.py
+*/
+inline void unpackWords(const uint8_t *bytes, size_t numElements, uint32_t bytesPerElement, uint64_t *out) {
+
+	switch (bytesPerElement) {
+		case 1:
+			for (size_t i = 0; i < numElements; ++i)
+				out[i] = bytes[i];
+			break;
+		case 2:
+			for (size_t i = 0; i < numElements; ++i)
+				out[i] = uint64_t(bytes[2 * i]) | uint64_t(bytes[2 * i + 1]) << 8;
+			break;
+		default:
+			for (size_t i = 0; i < numElements; ++i) {
+				uint64_t value = 0;
+				for (uint32_t j = bytesPerElement; j-- > 0; )
+					value = value << 8 | bytes[i * bytesPerElement + j];
+				out[i] = value;
+			}
+			break;
+	}
+}
+
 // std::string pad_string(std::string &s, int n) {
 // 	std::ostringstream oss;
 // 	oss << std::setw(n) << s;
@@ -0,0 +1,18 @@
+#!/bin/sh
+# Runs the photonic tensor core tutorial (sst_config_no3.py) in both precisions with an element built with
+# --enable-allocation-count: every event handler runs under an AllocationScope and the simulation aborts
+# if a warm handler allocates. Skipped (exit 77) if sst is not installed. Run with "make check".
+set -e
+
+if ! command -v sst > /dev/null 2>&1; then
+	echo "sst not found, skipping the allocation check"
+	exit 77
+fi
+
+TESTS_DIR=$(cd "$(dirname "$0")" && pwd)
+cd "$TESTS_DIR/../../tutorials/1_Photonic_Tensor_Core"
+
+for precision in double single; do
+	echo "sst_config_no3.py -precision $precision"
+	sst sst_config_no3.py -- -precision "$precision" -seed 1
+done
@@ -0,0 +1,345 @@
+// Copyright (2025) Hewlett Packard Enterprise Development LP
+// 
+// Licensed under the MIT License (the "License")
+//
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+
+
+// Tests of the allocation counter of --enable-allocation-count builds (Kernels/allocation_counter.cc):
+// the replaced operator new counts the allocations (also the aligned ones of the event payloads),
+// an AllocationCheck aborts on an allocating warm event,
+// and the handlers of the pipeline DAC -> modulator -> mesh -> photo detector -> ADC do not allocate once warm.
+// The handlers are driven without SST: every step runs the kernels, payload pools and workspace code the component
+// calls in its handleSelf(), with one AllocationCheck per handler. The SST event handlers themselves are checked
+// by tests/run_allocation_check.sh. Run with "make check".
+
+#include "../src_cpp/Kernels/allocation_counter.h"
+#include "../src_cpp/Kernels/adc_kernels.h"
+#include "../src_cpp/Kernels/clements_kernels.h"
+#include "../src_cpp/Kernels/dac_kernels.h"
+#include "../src_cpp/Kernels/detector_kernels.h"
+#include "../src_cpp/Kernels/digital_kernels.h"
+#include "../src_cpp/Kernels/modulator_kernels.h"
+#include "../src_cpp/Events/payload_pool.h"
+#include "test_check.h"
+
+#include <algorithm>
+#include <complex>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace SST::BYOD;
+
+namespace {
+
+char* volatile escape; //keeps the test allocations from being optimized away
+
+void testCounter() {
+
+	const uint64_t count = AllocationCounter::count();
+	const uint64_t bytes = AllocationCounter::bytes();
+	escape = new char[1000];
+	delete[] escape;
+	CHECK(AllocationCounter::count() - count == 1, "%llu allocations counted for one new[]", (unsigned long long)(AllocationCounter::count() - count));
+	CHECK(AllocationCounter::bytes() - bytes == 1000, "%llu bytes counted for new char[1000]", (unsigned long long)(AllocationCounter::bytes() - bytes));
+}
+
+/**
+* @brief run f in a child process and return its termination signal, 0 if it exited normally
+*/
+template <typename F>
+int signalOf(F &&f) {
+
+	std::fflush(stderr);
+	const pid_t pid = fork();
+	if(pid == 0) {
+		f();
+		_exit(0);
+	}
+	int status = 0;
+	waitpid(pid, &status, 0);
+	return WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+}
+
+void testCheck() {
+
+	const int warm = signalOf([]() { //allocations during the warmup events are allowed
+		AllocationCheck check("warmup", 4);
+		for(int event = 0; event < 4; event++) {
+			AllocationScope scope(check);
+			escape = new char[16];
+			delete[] escape;
+		}
+	});
+	CHECK(warm == 0, "an allocation during the warmup aborted the check (signal %d)", warm);
+
+	const int aborted = signalOf([]() {
+		AllocationCheck check("warm handler", 4);
+		for(int event = 0; event < 8; event++) {
+			AllocationScope scope(check);
+			if(event == 6) {
+				escape = new char[16];
+				delete[] escape;
+			}
+		}
+	});
+	CHECK(aborted == SIGABRT, "an allocation of a warm event did not abort (signal %d)", aborted);
+}
+
+/**
+* @brief the payloads start at a multiple of payloadAlignment, their aligned allocations are counted
+*/
+template <typename T>
+void testPayloadAlignment() {
+
+	for(size_t n : {1, 3, 17, 1000}) {
+
+		const uint64_t count = AllocationCounter::count();
+		Payload<T> payload(n);
+		CHECK(AllocationCounter::count() - count == 1, "%llu allocations counted for a payload", (unsigned long long)(AllocationCounter::count() - count));
+		CHECK(reinterpret_cast<uintptr_t>(payload.data()) % payloadAlignment == 0, "payload of %zu entries is not aligned", n);
+
+		PayloadPool<T>::release(std::move(payload));
+		Payload<T> pooled = PayloadPool<T>::acquire(n);
+		CHECK(reinterpret_cast<uintptr_t>(pooled.data()) % payloadAlignment == 0, "pooled payload of %zu entries is not aligned", n);
+		PayloadPool<T>::release(std::move(pooled));
+	}
+}
+
+/**
+* @brief the handlers of a pipeline with meshes of size size, T is the field type of the modulator, mesh and photo detector
+* @details each handler keeps the per-instance state of its component (workspaces, rotations, transfer matrix)
+* and passes its payload on like the events do: the output payload is taken from the pool, the input payload returns to it
+*/
+template <typename T>
+struct Pipeline {
+
+	static const uint32_t resolution = 8;
+
+	uint32_t size;
+	PropagationMode mode;
+	AllocationCheck dac{"DAC::handleSelf"};
+	AllocationCheck modulator{"amplitudeModulator::handleSelf"};
+	AllocationCheck mesh{"clements::handleSelf"};
+	AllocationCheck detector{"photoDetector::handleSelf"};
+	AllocationCheck adc{"ADC::handleSelf"};
+
+	Payload<double> amplitudes; //amplitudeModulator, single precision only
+	double modulatorPower = 0.0;
+	Payload<T> workspace; //clements
+	std::vector<T> rotations;
+	std::vector<std::complex<T>> transferMatrix;
+	ClementsKernels::MeshKernels<T> kernels;
+
+	Pipeline(uint32_t size, PropagationMode mode) : size(size), mode(mode), kernels(ClementsKernels::selectKernels<T>(size)) {
+
+		std::vector<double> phases(ClementsKernels::numPhases(size));
+		for(size_t i = 0; i < phases.size(); i++)
+			phases[i] = 0.1 * i;
+		if(mode == PropagationMode::Layered) {
+			rotations.resize(2 * phases.size());
+			ClementsKernels::phaseRotations(phases.data(), size, rotations.data());
+		}
+		else {
+			transferMatrix.resize(size_t(size) * size);
+			ClementsKernels::reconstruct(transferMatrix.data(), size, phases.data());
+		}
+	}
+
+	/**
+	* @brief DAC::handleSelf(), the codes return to the pool with the input event
+	*/
+	Payload<double> convertCodes(Payload<uint8_t> &&codes) {
+
+		Payload<double> voltages;
+		{
+			AllocationScope scope(dac);
+			voltages = PayloadPool<double>::acquire(codes.size());
+			DACKernels::codesToVoltages(codes.data(), voltages.data(), codes.size(), DACKernels::voltageStep(0.0, 1.0, resolution));
+		}
+		PayloadPool<uint8_t>::release(std::move(codes));
+		return voltages;
+	}
+
+	/**
+	* @brief amplitudeModulator::modulate() with a thermo-optic modulator without DAC lookup tables
+	*/
+	Payload<T> modulate(Payload<double> &&voltages) {
+
+		const size_t n = voltages.size();
+		Payload<T> output;
+		{
+			AllocationScope scope(modulator);
+			output = PayloadPool<T>::acquire(2 * n);
+			double* values;
+			if constexpr (std::is_same<T, double>::value)
+				values = output.data();
+			else {
+				growWorkspace(amplitudes, n);
+				values = amplitudes.data();
+			}
+			std::copy(voltages.begin(), voltages.end(), values);
+			modulatorPower = ModulatorKernels::heaterPower(values, n, 1e3);
+			ModulatorKernels::thermoOpticAmplitudes(values, n, 1e3, 25e-3);
+			ModulatorKernels::interleaveAmplitudes(values, output.data(), n, 1.0);
+		}
+		PayloadPool<double>::release(std::move(voltages));
+		return output;
+	}
+
+	/**
+	* @brief clements::propagateBatch(), the field of the input event is reused for the output event
+	* @details the matrix mode multiplies with a plain product where the mesh calls the BLAS GEMM
+	*/
+	void propagate(Payload<T> &buffer, uint32_t batchSize) {
+
+		growWorkspace(workspace, buffer.size());
+		AllocationScope scope(mesh);
+		std::complex<T>* field = reinterpret_cast<std::complex<T>*>(buffer.data());
+		std::complex<T>* work = reinterpret_cast<std::complex<T>*>(workspace.data());
+
+		if(mode == PropagationMode::Layered)
+			ClementsKernels::propagateBatch(kernels, field, work, size, batchSize, rotations.data());
+		else {
+			if(kernels.multiply)
+				kernels.multiply(field, transferMatrix.data(), work, batchSize);
+			else
+				multiply(field, work, batchSize);
+			ClementsKernels::takeProduct(buffer, workspace);
+		}
+	}
+
+	void multiply(const std::complex<T>* field, std::complex<T>* out, uint32_t rows) const {
+
+		for(uint32_t r = 0; r < rows; r++)
+			for(uint32_t i = 0; i < size; i++) {
+				std::complex<T> sum = T(0.0);
+				for(uint32_t j = 0; j < size; j++)
+					sum += transferMatrix[size_t(i) * size + j] * field[size_t(r) * size + j];
+				out[size_t(r) * size + i] = sum;
+			}
+	}
+
+	/**
+	* @brief photoDetector::detect() in single mode, the field is reused for the output voltages
+	*/
+	void detect(Payload<T> &field) {
+
+		AllocationScope scope(detector);
+		const size_t n = field.size() / 2;
+		DetectorKernels::intensities(field.data(), n, 1.0);
+		field.resize(n);
+	}
+
+	/**
+	* @brief ADC::handleSelf(), the payload of the output event is taken from the pool before the scope, like in its constructor
+	*/
+	Payload<uint8_t> quantize(Payload<T> &&voltages) {
+
+		Payload<uint8_t> codes = PayloadPool<uint8_t>::acquire(voltages.size());
+		{
+			AllocationScope scope(adc);
+			ADCKernels::quantize(voltages.data(), codes.data(), voltages.size(), ADCKernels::quantizationStep(0.0, 1.0, resolution), DigitalKernels::maxCode(resolution));
+		}
+		PayloadPool<T>::release(std::move(voltages));
+		return codes;
+	}
+
+	/**
+	* @brief one batch from the StreamingCPU through all handlers back to the CPU, which releases the codes
+	*/
+	void event(uint32_t id, uint32_t batchSize) {
+
+		Payload<uint8_t> codes = PayloadPool<uint8_t>::acquire(size_t(batchSize) * size);
+		for(size_t i = 0; i < codes.size(); i++)
+			codes[i] = uint8_t(id + i);
+
+		Payload<T> field = modulate(convertCodes(std::move(codes)));
+		propagate(field, batchSize);
+		detect(field);
+		PayloadPool<uint8_t>::release(quantize(std::move(field)));
+	}
+};
+
+/**
+* @brief run the pipeline with batches that grow during the warmup of the checks and mixed batches afterwards,
+* the warm events must not allocate and the workspaces must hold the largest batch
+*/
+template <typename T>
+void testPipeline(uint32_t size, PropagationMode mode) {
+
+	const uint32_t batchSizes[] = {1, 2, 4, 8, 3, 1, 8, 5};
+	const char* name = mode == PropagationMode::Layered ? "layered" : "matrix";
+	const char* precision = std::is_same<T, double>::value ? "double" : "single";
+
+	const int signal = signalOf([&]() {
+
+		Pipeline<T> pipeline(size, mode);
+		pipeline.event(0, 1);
+		if(pipeline.workspace.size() != 2 * size_t(size))
+			_exit(2);
+		for(uint32_t event = 1; event < 200; event++)
+			pipeline.event(event, batchSizes[event % 8]);
+		if(pipeline.workspace.size() != 2 * size_t(size) * 8 || pipeline.mesh.events != 200)
+			_exit(3);
+		if(!std::is_same<T, double>::value && pipeline.amplitudes.size() != size_t(size) * 8)
+			_exit(4);
+	});
+	CHECK(signal == 0, "%s %s pipeline of size %u allocated once warm (signal %d)", name, precision, size, signal);
+}
+
+/**
+* @brief a batch larger than every batch of the warmup grows the payloads and the workspaces, the check must catch it
+*/
+void testLateGrowth() {
+
+	const int signal = signalOf([]() {
+		Pipeline<double> pipeline(8, PropagationMode::Layered);
+		for(uint32_t event = 0; event < 32; event++)
+			pipeline.event(event, 1 + event % 4);
+		pipeline.event(32, 16);
+	});
+	CHECK(signal == SIGABRT, "a batch larger than the warmup batches did not abort (signal %d)", signal);
+}
+} // namespace
+
+int main() {
+
+	testCounter();
+	testCheck();
+	testPayloadAlignment<double>();
+	testPayloadAlignment<float>();
+	testPayloadAlignment<uint8_t>();
+	for(uint32_t size : {4, 8, 16, 33, 64}) {
+		for(PropagationMode mode : {PropagationMode::Layered, PropagationMode::Matrix}) {
+			testPipeline<double>(size, mode);
+			testPipeline<float>(size, mode);
+		}
+	}
+	testLateGrowth();
+
+	return TestCheck::checkResult();
+}
@@ -0,0 +1,34 @@
+#ifndef _testCheck_H
+#define _testCheck_H
+
+// Checks shared by the tests of "make check": CHECK prints every failed condition with its location
+// and counts it, main() returns checkResult() as exit code.
+
+#include <cstdio>
+
+namespace TestCheck {
+
+inline int failures = 0;
+
+/**
+* @brief exit code of a test, 1 if a check failed
+*/
+inline int checkResult() {
+
+	if(failures)
+		std::fprintf(stderr, "%d checks failed\n", failures);
+	return failures ? 1 : 0;
+}
+} // namespace TestCheck
+
+#define CHECK(condition, ...) \
+	do { \
+		if(!(condition)) { \
+			std::fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+			std::fprintf(stderr, __VA_ARGS__); \
+			std::fprintf(stderr, "\n"); \
+			TestCheck::failures++; \
+		} \
+	} while(0)
+
+#endif
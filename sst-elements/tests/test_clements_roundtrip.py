@@ -0,0 +1,53 @@
+import os
+import sys
+FILE_DIR = os.path.dirname(os.path.abspath(__file__))
+sys.path.append(os.path.join(FILE_DIR, '..', '..', 'utils'))
+import numpy as np
+from scipy.stats import unitary_group
+from byod_components import ClementsMesh, CLEMENTS_LIBRARY
+
+# Round trip of the Clements decomposition against the phase convention of the mesh component:
+# random unitaries are decomposed by the compiled library (libbyodclements) and by the numpy port
+# (ClementsMesh.decompose_analytic), and both phase sets are rebuilt with ClementsKernels::reconstruct,
+# the kernel of clements::reconstructUnitaryMatrix. Run with "make check" or with BYOD_CLEMENTS_LIB
+# pointing to libbyodclements.so.
+
+sizes = [2, 3, 4, 5, 8, 9, 16, 33, 64]
+repeats = 5
+tolerance = 1e-9 #max. deviation of an entry of the rebuilt matrix
+
+if CLEMENTS_LIBRARY is None:
+    print("libbyodclements.so not found, build the element or set BYOD_CLEMENTS_LIB")
+    sys.exit(77) #skipped test for automake
+
+def reconstruct(phases, dim):
+    # transfer matrix of the mesh computed by ClementsKernels::reconstruct
+    mat = np.zeros((dim, dim), dtype=np.complex128)
+    CLEMENTS_LIBRARY.byod_clements_reconstruct(np.ascontiguousarray(phases, dtype=np.float64), dim, mat)
+    return mat
+
+failures = 0
+for dim in sizes:
+    mesh = ClementsMesh(size = dim)
+    for repeat in range(repeats):
+        u = np.ascontiguousarray(unitary_group.rvs(dim, random_state = 1000 * dim + repeat), dtype=np.complex128)
+
+        phases_lib = np.zeros(dim * dim)
+        if CLEMENTS_LIBRARY.byod_clements_decompose(u, dim, phases_lib, 1e-9) != 0:
+            print("size %d: unitary rejected by the library" % dim)
+            failures += 1
+            continue
+        phases_numpy = mesh.decompose_analytic(u)
+
+        errors = {
+            "library": np.abs(reconstruct(phases_lib, dim) - u).max(),
+            "numpy": np.abs(reconstruct(phases_numpy, dim) - u).max(),
+        }
+        for name, error in errors.items():
+            if not error < tolerance:
+                print("size %d, repeat %d: %s round trip deviates by %g" % (dim, repeat, name, error))
+                failures += 1
+
+    print("size %d: ok" % dim if failures == 0 else "size %d: %d failures so far" % (dim, failures))
+
+sys.exit(1 if failures else 0)
@@ -0,0 +1,184 @@
+// Copyright (2025) Hewlett Packard Enterprise Development LP
+// 
+// Licensed under the MIT License (the "License")
+//
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+
+
+// Bit-exact tests of the packed DigitalEvent payloads: packing and unpacking the codes, and the DAC and ADC
+// kernels on packed words against the uint64_t path they replace. Run with "make check".
+
+#include "../src_cpp/Kernels/digital_kernels.h"
+#include "../src_cpp/Kernels/dac_kernels.h"
+#include "../src_cpp/Kernels/adc_kernels.h"
+#include "test_check.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace SST::BYOD;
+
+namespace {
+
+const size_t numCodes = 4096;
+
+/**
+* @brief call f(T()) with the word type of the resolution, like DigitalEvent::visitCodes
+*/
+template <typename F>
+void withWordType(uint32_t resolution, F &&f) {
+	switch(DigitalKernels::wordBytes(resolution)) {
+		case 1: f(uint8_t()); break;
+		case 2: f(uint16_t()); break;
+		case 4: f(uint32_t()); break;
+		default: f(uint64_t()); break;
+	}
+}
+
+std::vector<uint64_t> randomCodes(uint32_t resolution, std::mt19937_64 &rng) {
+
+	std::vector<uint64_t> codes(numCodes);
+	const uint64_t maxCode = DigitalKernels::maxCode(resolution);
+	for(uint64_t &code : codes)
+		code = rng() & maxCode;
+	codes[0] = 0; //the extreme codes are always tested
+	codes[1] = maxCode;
+	return codes;
+}
+
+void testWordBytes() {
+
+	for(uint32_t resolution = 1; resolution <= 64; resolution++) {
+		const uint32_t bytes = DigitalKernels::wordBytes(resolution);
+		CHECK(bytes * 8 >= resolution, "resolution %u does not fit into %u bytes", resolution, bytes);
+		CHECK(bytes == 1 || (bytes / 2) * 8 < resolution, "resolution %u would fit into %u bytes", resolution, bytes / 2);
+	}
+	CHECK(DigitalKernels::maxCode(8) == 255, "maxCode(8) is %llu", (unsigned long long)DigitalKernels::maxCode(8));
+	CHECK(DigitalKernels::maxCode(64) == UINT64_MAX, "maxCode(64) is not UINT64_MAX");
+}
+
+/**
+* @brief pack -> unpack returns the codes of the resolution unchanged, wider codes saturate
+*/
+void testRoundTrip(std::mt19937_64 &rng) {
+
+	for(uint32_t resolution = 1; resolution <= 64; resolution++)
+		withWordType(resolution, [&](auto word) {
+
+			using T = decltype(word);
+			const std::vector<uint64_t> codes = randomCodes(resolution, rng);
+			const uint64_t maxCode = DigitalKernels::maxCode(resolution);
+			std::vector<T> packed(codes.size());
+			std::vector<uint64_t> unpacked(codes.size());
+
+			DigitalKernels::pack(codes.data(), packed.data(), codes.size(), maxCode);
+			DigitalKernels::unpack(packed.data(), unpacked.data(), packed.size());
+			CHECK(unpacked == codes, "round trip of resolution %u changed the codes", resolution);
+
+			if(resolution < 64) { //codes above the resolution saturate instead of wrapping around the word size
+				const uint64_t wide[] = {maxCode + 1, uint64_t(1) << (8 * sizeof(T) - 1), UINT64_MAX};
+				T out[3];
+				DigitalKernels::pack(wide, out, 3, maxCode);
+				for(int i = 0; i < 3; i++)
+					CHECK(uint64_t(out[i]) == std::min(wide[i], maxCode) && uint64_t(out[i]) <= maxCode,
+						"code %llu packed to %llu at resolution %u", (unsigned long long)wide[i], (unsigned long long)out[i], resolution);
+			}
+		});
+}
+
+/**
+* @brief the DAC voltages of packed codes are bit-identical to the voltages of the uint64_t codes
+*/
+void testDAC(std::mt19937_64 &rng) {
+
+	for(uint32_t resolution = 1; resolution <= 32; resolution++)
+		withWordType(resolution, [&](auto word) {
+
+			using T = decltype(word);
+			const std::vector<uint64_t> codes = randomCodes(resolution, rng);
+			std::vector<T> packed(codes.size());
+			DigitalKernels::pack(codes.data(), packed.data(), codes.size(), DigitalKernels::maxCode(resolution));
+
+			const double step = DACKernels::voltageStep(-0.5, 1.0, resolution);
+			std::vector<double> reference(codes.size());
+			std::vector<double> voltages(codes.size());
+			DACKernels::codesToVoltages(codes.data(), reference.data(), codes.size(), step);
+			DACKernels::codesToVoltages(packed.data(), voltages.data(), packed.size(), step);
+			CHECK(std::memcmp(reference.data(), voltages.data(), voltages.size() * sizeof(double)) == 0,
+				"DAC voltages of packed codes differ at resolution %u", resolution);
+		});
+}
+
+/**
+* @brief the ADC codes are identical for every word type, the codes of the input range match the uint64_t quantization
+* before packing and voltages outside of the range saturate
+*/
+template <typename In>
+void testADC(std::mt19937_64 &rng) {
+
+	const double maxVin = 1.0;
+	std::uniform_real_distribution<double> dist(-0.5 * maxVin, 1.5 * maxVin); //a quarter of the voltages is out of range
+
+	for(uint32_t resolution = 1; resolution <= 32; resolution++)
+		withWordType(resolution, [&](auto word) {
+
+			using T = decltype(word);
+			std::vector<In> voltages(numCodes);
+			for(In &v : voltages)
+				v = In(dist(rng));
+			voltages[0] = In(0.0);
+			voltages[1] = In(maxVin);
+
+			const double step = ADCKernels::quantizationStep(0.0, maxVin, resolution);
+			const uint64_t maxCode = DigitalKernels::maxCode(resolution);
+			std::vector<T> packed(voltages.size());
+			std::vector<uint64_t> wide(voltages.size());
+			std::vector<T> repacked(voltages.size());
+			ADCKernels::quantize(voltages.data(), packed.data(), voltages.size(), step, maxCode);
+			ADCKernels::quantize(voltages.data(), wide.data(), voltages.size(), step, maxCode);
+			DigitalKernels::pack(wide.data(), repacked.data(), wide.size(), maxCode);
+			CHECK(packed == repacked, "ADC codes of the packed and the uint64_t path differ at resolution %u", resolution);
+
+			for(size_t i = 0; i < voltages.size(); i++) {
+
+				const double level = double(voltages[i]) / step;
+				const uint64_t expected = level <= 0.0 ? 0 : level >= double(maxCode) ? maxCode : static_cast<uint64_t>(level); //uint64_t quantization of the input range
+				CHECK(uint64_t(packed[i]) == expected, "voltage %.17g quantized to %llu instead of %llu at resolution %u",
+					double(voltages[i]), (unsigned long long)packed[i], (unsigned long long)expected, resolution);
+			}
+			CHECK(uint64_t(packed[1]) == maxCode, "maxVin is not quantized to the largest code at resolution %u", resolution);
+		});
+}
+} // namespace
+
+int main() {
+
+	std::mt19937_64 rng(42);
+	testWordBytes();
+	testRoundTrip(rng);
+	testDAC(rng);
+	testADC<double>(rng);
+	testADC<float>(rng);
+
+	return TestCheck::checkResult();
+}
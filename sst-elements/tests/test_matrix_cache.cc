@@ -0,0 +1,228 @@
+// Copyright (2025) Hewlett Packard Enterprise Development LP
+// 
+// Licensed under the MIT License (the "License")
+//
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+
+
+
+// Tests of the LRU cache of reconstructed transfer matrices (Kernels/matrix_cache.h): LRU order, eviction by the
+// number of entries and by bytes, rejected oversized entries and hash collisions, which must be misses. Run with "make check".
+
+#include "../src_cpp/Kernels/matrix_cache.h"
+#include "test_check.h"
+
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace SST::BYOD;
+
+namespace {
+
+const size_t numPhases = 4;
+const size_t matrixSize = 4;
+
+/**
+* @brief phases of mesh k, every mesh has different phases
+*/
+std::vector<double> phasesOf(int k) {
+
+	std::vector<double> phases(numPhases);
+	for(size_t i = 0; i < numPhases; i++)
+		phases[i] = 0.5 * k + 0.1 * i;
+	return phases;
+}
+
+/**
+* @brief matrix of mesh k, every entry is k so a hit can be traced back to its entry
+*/
+template <typename T>
+std::vector<std::complex<T>> matrixOf(int k, size_t m = matrixSize) {
+	return std::vector<std::complex<T>>(m, std::complex<T>(T(k), T(-k)));
+}
+
+template <typename T>
+void insert(TransferMatrixCache<T> &cache, int k) {
+
+	const std::vector<double> phases = phasesOf(k);
+	const std::vector<std::complex<T>> matrix = matrixOf<T>(k);
+	cache.insert(phases.data(), phases.size(), matrix.data(), matrix.size());
+}
+
+/**
+* @brief true if the cache holds the matrix of mesh k, a hit makes it the most recently used entry
+*/
+template <typename T>
+bool contains(TransferMatrixCache<T> &cache, int k) {
+
+	const std::vector<double> phases = phasesOf(k);
+	const std::complex<T>* matrix = cache.find(phases.data(), phases.size());
+	return matrix && std::memcmp(matrix, matrixOf<T>(k).data(), matrixSize * sizeof(std::complex<T>)) == 0;
+}
+
+template <typename T>
+size_t entryBytes() {
+	return numPhases * sizeof(double) + matrixSize * sizeof(std::complex<T>);
+}
+
+template <typename T>
+void testDisabled() {
+
+	TransferMatrixCache<T> cache;
+	CHECK(!cache.enabled(), "a cache without limits is enabled");
+	insert(cache, 1);
+	CHECK(cache.entries() == 0 && !contains(cache, 1), "a disabled cache stored an entry");
+}
+
+template <typename T>
+void testLRUOrder() {
+
+	TransferMatrixCache<T> cache;
+	cache.configure(3, 0);
+	insert(cache, 1);
+	insert(cache, 2);
+	insert(cache, 3); //LRU order 3 2 1
+	CHECK(contains(cache, 1), "entry 1 missing"); //1 3 2
+	insert(cache, 4); //4 1 3, 2 is evicted
+	CHECK(contains(cache, 3), "entry 3 missing"); //3 4 1
+	insert(cache, 5); //5 3 4, 1 is evicted
+
+	CHECK(cache.entries() == 3, "%zu entries in a cache of 3 entries", cache.entries());
+	CHECK(!contains(cache, 2), "entry 2 was not the least recently used entry");
+	CHECK(!contains(cache, 1), "entry 1 was not the least recently used entry");
+	CHECK(contains(cache, 3) && contains(cache, 4) && contains(cache, 5), "a recently used entry was evicted");
+}
+
+template <typename T>
+void testEntryLimit() {
+
+	TransferMatrixCache<T> cache;
+	cache.configure(2, 0);
+	for(int k = 0; k < 10; k++)
+		insert(cache, k);
+
+	CHECK(cache.entries() == 2, "%zu entries in a cache of 2 entries", cache.entries());
+	CHECK(cache.bytes() == 2 * entryBytes<T>(), "%zu bytes counted for 2 entries", cache.bytes());
+	CHECK(contains(cache, 8) && contains(cache, 9), "the last inserted entries were evicted");
+
+	insert(cache, 9); //inserting an entry again replaces it
+	CHECK(cache.entries() == 2 && cache.bytes() == 2 * entryBytes<T>(), "a reinserted entry was counted twice");
+}
+
+template <typename T>
+void testByteLimit() {
+
+	TransferMatrixCache<T> cache;
+	cache.configure(0, 3 * entryBytes<T>() - 1); //room for two entries
+	insert(cache, 1);
+	insert(cache, 2);
+	insert(cache, 3);
+
+	CHECK(cache.entries() == 2, "%zu entries in a cache with room for 2 entries", cache.entries());
+	CHECK(cache.bytes() == 2 * entryBytes<T>(), "%zu bytes counted for 2 entries", cache.bytes());
+	CHECK(!contains(cache, 1) && contains(cache, 2) && contains(cache, 3), "the least recently used entry was not evicted");
+
+	cache.configure(5, 2 * entryBytes<T>()); //both limits, the byte limit is hit first
+	for(int k = 0; k < 5; k++)
+		insert(cache, k);
+	CHECK(cache.entries() == 2 && cache.bytes() <= 2 * entryBytes<T>(), "%zu entries of %zu bytes exceed the byte limit", cache.entries(), cache.bytes());
+}
+
+template <typename T>
+void testOversized() {
+
+	TransferMatrixCache<T> cache;
+	cache.configure(0, 2 * entryBytes<T>());
+	insert(cache, 1);
+
+	const std::vector<double> phases = phasesOf(2);
+	const std::vector<std::complex<T>> matrix = matrixOf<T>(2, 4 * matrixSize); //larger than the whole cache
+	cache.insert(phases.data(), phases.size(), matrix.data(), matrix.size());
+
+	CHECK(cache.find(phases.data(), phases.size()) == nullptr, "an entry larger than the cache was stored");
+	CHECK(cache.entries() == 1 && contains(cache, 1), "an oversized entry evicted the cached entries");
+	CHECK(cache.bytes() == entryBytes<T>(), "%zu bytes counted after an oversized entry", cache.bytes());
+}
+
+/**
+* @brief second phases with the same hash as first, the last phase is solved from the FNV-1a steps
+*/
+std::vector<double> collidingPhases(const std::vector<double> &first) {
+
+	const uint64_t prime = 1099511628211ull;
+	std::vector<double> second = first;
+	second[0] += 1.0;
+
+	uint64_t hashFirst = 14695981039346656037ull, hashSecond = hashFirst; //hash state before the last phase
+	for(size_t i = 0; i + 1 < first.size(); i++) {
+		uint64_t bits;
+		std::memcpy(&bits, &first[i], sizeof(bits));
+		hashFirst = (hashFirst ^ bits) * prime;
+		std::memcpy(&bits, &second[i], sizeof(bits));
+		hashSecond = (hashSecond ^ bits) * prime;
+	}
+	uint64_t last;
+	std::memcpy(&last, &first.back(), sizeof(last));
+	last ^= hashFirst ^ hashSecond;
+	std::memcpy(&second.back(), &last, sizeof(last));
+	return second;
+}
+
+template <typename T>
+void testCollision() {
+
+	const std::vector<double> first = phasesOf(1);
+	const std::vector<double> second = collidingPhases(first);
+	CHECK(TransferMatrixCache<T>::hash(first.data(), numPhases) == TransferMatrixCache<T>::hash(second.data(), numPhases), "the phases do not collide");
+	CHECK(std::memcmp(first.data(), second.data(), numPhases * sizeof(double)) != 0, "the colliding phases are identical");
+
+	TransferMatrixCache<T> cache;
+	cache.configure(4, 0);
+	insert(cache, 1);
+	CHECK(cache.find(second.data(), numPhases) == nullptr, "a hash collision returned the matrix of other phases");
+
+	const std::vector<std::complex<T>> matrix = matrixOf<T>(2);
+	cache.insert(second.data(), numPhases, matrix.data(), matrix.size()); //replaces the entry with the same hash
+	const std::complex<T>* found = cache.find(second.data(), numPhases);
+	CHECK(found && found[0] == std::complex<T>(T(2), T(-2)), "the colliding entry was not stored");
+	CHECK(!contains(cache, 1), "a hash collision returned the matrix of other phases");
+	CHECK(cache.entries() == 1 && cache.bytes() == entryBytes<T>(), "%zu entries of %zu bytes after a collision", cache.entries(), cache.bytes());
+}
+
+template <typename T>
+void testCache() {
+
+	testDisabled<T>();
+	testLRUOrder<T>();
+	testEntryLimit<T>();
+	testByteLimit<T>();
+	testOversized<T>();
+	testCollision<T>();
+}
+} // namespace
+
+int main() {
+
+	testCache<double>();
+	testCache<float>();
+
+	return TestCheck::checkResult();
+}
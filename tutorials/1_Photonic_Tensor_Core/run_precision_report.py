@@ -0,0 +1,51 @@
+import os
+import sys
+FILE_DIR = os.path.dirname(os.path.abspath(__file__))
+sys.path.append(FILE_DIR)
+import subprocess
+import numpy as np
+
+# --- Set up the comparison ---
+
+precisions = ["double", "single"] #the double precision run is the reference
+seed = 0 #both runs compute the same test data and matrix
+codes = {}
+output_dir = os.path.join(FILE_DIR, "output") #all paths are relative to the tutorial, not to the current directory
+os.makedirs(output_dir, exist_ok = True)
+
+# --- Run the simulation once per precision and collect the ADC codes received by the CPU ---
+
+for precision in precisions:
+
+    result_path = os.path.join(output_dir, "adc_" + precision + ".csv")
+    if os.path.exists(result_path): #a failed run must not leave the codes of an earlier run behind
+        os.remove(result_path)
+    subprocess.run(["sst", "sst_config_no3.py", "--", "-precision", precision, "-seed", str(seed), "-results", result_path], cwd = FILE_DIR, check = True) #run the simulation with command line arguments "$sst sst_config_no3.py -- -precision <precision> -seed <seed> -results <file>", raises if sst fails
+    if not os.path.exists(result_path):
+        raise RuntimeError("the " + precision + " precision run did not write " + result_path)
+
+    data = np.loadtxt(result_path, delimiter = ',', dtype = np.int64, ndmin = 2)
+    data = data[np.argsort(data[:, 0])] #one line per vector, the first column is the vector id
+    codes[precision] = data[:, 1:]
+
+# --- Compare the single precision codes with the double precision codes ---
+
+reference = codes["double"]
+single = codes["single"]
+if reference.shape != single.shape:
+    raise RuntimeError("the runs received a different number of vectors: " + str(reference.shape) + " vs. " + str(single.shape))
+
+error = np.abs(single - reference) #error in LSB of the ADC
+report = [
+    "vectors: " + str(reference.shape[0]),
+    "codes: " + str(reference.size),
+    "mismatched codes: " + str(np.count_nonzero(error)),
+    "mismatch fraction: " + str(np.count_nonzero(error) / reference.size),
+    "max abs error (LSB): " + str(np.max(error)),
+    "mean abs error (LSB): " + str(np.mean(error)),
+]
+
+print('Precision report finished')
+print("\n".join(report))
+with open(os.path.join(output_dir, "precision_report.txt"), "w") as file:
+    file.write("\n".join(report) + "\n")
@@ -14,8 +14,16 @@ from argparse import ArgumentParser
 parser = ArgumentParser()
 parser.add_argument("-clock", type=float,
                     help="set the clock frequency in GHz", default = 1.0) #clock frequency can be set as command line argument when running the SST simulation
+parser.add_argument("-precision", type=str,
+                    help="scalar type of the optical field and the mesh matrices, double or single", default = "double")
+parser.add_argument("-seed", type=int,
+                    help="seed for the random test data, runs with the same seed compute the same data", default = None)
+parser.add_argument("-results", type=str,
+                    help="CSV file the CPU writes the received ADC codes to", default = "")
 args = parser.parse_args()
 clock = str(args.clock) +f"Ghz"
+if args.seed is not None:
+    np.random.seed(args.seed)
 size = 8 #size of the data vector
 resolution = 8 #bit resolution of the data
 data_size = 50 #number of data points
@@ -26,6 +34,7 @@ vmax = np.sqrt(P_pi * 2 * R) #voltage to achieve a 2pi phase shift
 DEBUG_LEVEL = 0
 STATISTICSPATH = os.path.abspath(os.path.join(FILE_DIR, "output/sim_output.csv"))
 STATISTICSPATH_DRAM = os.path.abspath(os.path.join(FILE_DIR, "output"))
+MEMORYPATH = os.path.abspath(os.path.join(FILE_DIR, "output/memory_image.npy"))
 DRAM_CONFIG = os.path.abspath(os.path.join(FILE_DIR,'../../utils/DRAM_configs/LPDDR4_8Gb_x16_2400.ini'))
 
 # --- Set up helper functions for each component (energy models, data pre-processing, ...) ---
@@ -70,18 +79,20 @@ weight_bytes = np.append(weight_bytes, cpu_helper.getBytesFromLevels(adlevels_s)
 weight_bytes = np.append(weight_bytes, cpu_helper.getBytesFromLevels(adlevels_v))
 
 data_bytes = cpu_helper.getBytesFromLevels(adlevels_data)
+cpu_helper.writeMemoryImage(MEMORYPATH, np.append(weight_bytes, data_bytes)) # the CPU maps the image instead of receiving it as a parameter list
 
 # --- Set up the CPU ---
 
 cpu = sst.Component("test", "byod.StreamingCPU")
 cpu.addParams({
-    "memory": (np.append(weight_bytes, data_bytes)).tolist(),
+    "memoryFile": MEMORYPATH,
     "weight_address": (np.array([0, len(weight_bytes), len(weight_bytes) / np.ceil(resolution/8), resolution]).flatten()).tolist(),
     "vector_base_addr": len(weight_bytes),
     "size": size,
     "resolution": resolution,
     "frequency": clock,
     "vector_count": len(test_data) / size,
+    "resultFile": args.results,
     "verbose": DEBUG_LEVEL,
 })
 
@@ -142,6 +153,7 @@ mod.addParams({
     "size": size,
     "laserPower": 0.005,
     "laserWpe": 0.5,
+    "precision": args.precision,
     "verbose": DEBUG_LEVEL,
 })
 
@@ -150,7 +162,9 @@ mod.addParams({
 ampMod = mod.setSubComponent("modulator", "byod.thermoOpticModulator")
 ampMod.addParams({
     "resistance": R,
-    "p_pi": P_pi
+    "p_pi": P_pi,
+    "dacResolution": resolution,
+    "dacMaxVout": vmax,
 })
 
 # --- Set up the optical mesh for performing a matrix-vector multiplication on the input data ---
@@ -160,6 +174,7 @@ mesh.enableAllStatistics()
 mesh.addParams({
     "size": size,
     "opticalLoss": 0.0,
+    "precision": args.precision,
     "verbose": DEBUG_LEVEL,
 })
 
@@ -167,6 +182,8 @@ mesh_mod = mesh.setSubComponent("modulator", "byod.thermoOpticModulator")
 mesh_mod.addParams({
     "resistance": R,
     "p_pi": P_pi,
+    "dacResolution": resolution,
+    "dacMaxVout": vmax,
 })
 mesh_mod.enableAllStatistics()
 
@@ -1,8 +1,33 @@
+import os
+import ctypes
 import numpy as np
+from numpy.ctypeslib import ndpointer
 from scipy.stats import unitary_group
 from scipy.optimize import fsolve
 
 
+def loadClementsLibrary():
+    # compiled Clements decomposition (sst-elements/src_cpp/Kernels/clements_decompose.cc), None if it has not been built
+    root = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'sst-elements')
+    candidates = [
+        os.environ.get('BYOD_CLEMENTS_LIB', ''),
+        os.path.join(root, 'lib', 'byod', 'libbyodclements.so'), # make install with run_config.sh
+        os.path.join(root, '.libs', 'libbyodclements.so'), # make
+    ]
+    for path in candidates:
+        if not path or not os.path.exists(path):
+            continue
+        lib = ctypes.CDLL(path)
+        lib.byod_clements_decompose.argtypes = [ndpointer(np.complex128, flags='C_CONTIGUOUS'), ctypes.c_uint32, ndpointer(np.float64, flags='C_CONTIGUOUS'), ctypes.c_double]
+        lib.byod_clements_decompose.restype = ctypes.c_int
+        lib.byod_clements_reconstruct.argtypes = [ndpointer(np.float64, flags='C_CONTIGUOUS'), ctypes.c_uint32, ndpointer(np.complex128, flags='C_CONTIGUOUS')]
+        lib.byod_clements_reconstruct.restype = None
+        return lib
+    return None
+
+CLEMENTS_LIBRARY = loadClementsLibrary()
+
+
 class DAC():
     def __init__(self, resolution = 8, maxVin = 1.0):
         self.resolution = resolution
@@ -32,13 +57,22 @@ class StreamingCPU():
     def __init__(self, resolution = 8):
         self.resolution = resolution
 
-    def getBytesFromLevels(self, data):
-        data = data.astype(int)
+    def getBytesFromLevels(self, data, path = None):
+        data = np.asarray(data).astype('<u8').flatten()
         num_bytes = int(np.ceil(self.resolution / 8))
-        byte_array = []
-        for i in range(len(data)):
-            byte_array.append(list( bytearray( int(data[i]).to_bytes(num_bytes, 'little'))))
-        return byte_array
+        byte_array = data.view(np.uint8).reshape(-1, 8)[:, :num_bytes] # little-endian bytes of each level
+        if path is not None:
+            self.writeMemoryImage(path, byte_array)
+        return byte_array.tolist()
+
+    def writeMemoryImage(self, path, data):
+        # write a memory image for the "memoryFile" parameter, .npy if the path ends with .npy and raw bytes otherwise
+        data = np.asarray(data).astype(np.uint8).flatten()
+        if str(path).endswith('.npy'):
+            np.save(path, data)
+        else:
+            data.tofile(path)
+        return path
     
 class ADC():
     def __init__(self, resolution = 8):
@@ -239,11 +273,98 @@ class ClementsMesh(Modulator):
             
         return phases, dim
     
+    def _mzi(self, phi, theta):
+        # 2x2 block of U2MZI
+        return 1j * np.exp(1j * theta) * np.array([[np.exp(1j * phi) * np.sin(theta), np.cos(theta)],
+                                                    [np.exp(1j * phi) * np.cos(theta), -np.sin(theta)]])
+
+    def _column_offset(self, dim, column):
+        # index of the first phase of a mesh column, see ClementsKernels::columnOffset
+        return 2 * (((column + 1) // 2) * (dim // 2) + (column // 2) * ((dim - 1) // 2))
+
+    def decompose_analytic(self, u):
+        """
+        Clements decomposition with closed-form MZI angles instead of fsolve, same algorithm as
+        ClementsKernels::decompose in sst-elements/src_cpp/Kernels/clements_kernels.h.
+        Returns the dim * dim phases in the order of flatten_phase.
+        """
+        mat = np.array(u, dtype=np.complex128)
+        dim = mat.shape[0]
+        forward = np.zeros(dim, dtype=int) # next column slot per mode pair for MZIs applied from the right
+        backward = np.array([(dim - m % 2 + 1) // 2 - 1 for m in range(dim)]) # counting down for MZIs applied from the left
+        placements = []
+        left = []
+
+        def null_from_right(a, b):
+            return np.arctan2(np.abs(b), np.abs(a)), np.angle(a) - np.angle(b) + np.pi
+
+        for p in range(dim - 1):
+            for q in range(p + 1):
+                if p % 2 == 0: # null the entry (dim - 1 - q, p - q) from the right
+                    x, y = dim - 1 - q, p - q
+                    theta, phi = null_from_right(mat[x, y], mat[x, y + 1])
+                    mat[:, y:y + 2] = mat[:, y:y + 2] @ self._mzi(phi, theta).conj().T
+                    placements.append((y, forward[y], phi, theta))
+                    forward[y] += 1
+                else: # null the entry (dim - 1 - p + q, q) from the left
+                    x, y = dim - 1 - p + q, q
+                    theta, phi = np.arctan2(np.abs(mat[x - 1, y]), np.abs(mat[x, y])), np.angle(mat[x, y]) - np.angle(mat[x - 1, y])
+                    mat[x - 1:x + 1, :] = self._mzi(phi, theta) @ mat[x - 1:x + 1, :]
+                    left.append((x - 1, backward[x - 1], phi, theta))
+                    backward[x - 1] -= 1
+
+        for m, slot, phi, theta in reversed(left): # move the MZIs applied from the left through the diagonal matrix
+            mat[m:m + 2, :] = self._mzi(phi, theta).conj().T @ mat[m:m + 2, :]
+            theta, phi = null_from_right(mat[m + 1, m], mat[m + 1, m + 1])
+            mat[:, m:m + 2] = mat[:, m:m + 2] @ self._mzi(phi, theta).conj().T
+            placements.append((m, slot, phi, theta))
+
+        phases = np.zeros(dim * dim)
+        for m, slot, phi, theta in placements: # the k-th MZI of a mode pair m sits in column 2k + m % 2
+            offset = self._column_offset(dim, 2 * slot + m % 2)
+            pairs = (dim - m % 2) // 2
+            phases[offset + m // 2] = np.remainder(phi, 2 * np.pi)
+            phases[offset + pairs + m // 2] = 2 * theta
+        phases[self._column_offset(dim, dim):] = np.remainder(np.angle(np.diag(mat)), 2 * np.pi)
+        return phases
+
+    def getPhasesFromUnitary(self, u, tolerance = 1e-6):
+        # phases of the mesh, computed by the compiled library if it is available
+        u = np.ascontiguousarray(u, dtype=np.complex128)
+        if u.ndim != 2 or u.shape[0] != u.shape[1]:
+            raise ValueError("U(N) should be a square matrix.")
+        dim = u.shape[0]
+        if CLEMENTS_LIBRARY is None:
+            if np.abs(u @ u.conj().T - np.eye(dim)).max() > tolerance:
+                raise ValueError("U(N) is not unitary.")
+            return self.decompose_analytic(u)
+        phases = np.zeros(dim * dim)
+        if CLEMENTS_LIBRARY.byod_clements_decompose(u, dim, phases, tolerance) != 0:
+            raise ValueError("U(N) is not unitary.")
+        return phases
+
+    def getUnitaryFromPhases(self, phases):
+        # transfer matrix of the mesh, identical to clements::reconstructUnitaryMatrix
+        phases = np.ascontiguousarray(phases, dtype=np.float64)
+        dim = int(round(np.sqrt(phases.size)))
+        if CLEMENTS_LIBRARY is not None:
+            mat = np.zeros((dim, dim), dtype=np.complex128)
+            CLEMENTS_LIBRARY.byod_clements_reconstruct(phases, dim, mat)
+            return mat
+        mat = np.eye(dim, dtype=np.complex128)
+        index = 0
+        for column in range(dim):
+            start = column % 2
+            pairs = (dim - start) // 2
+            for k, m in enumerate(range(start, dim - 1, 2)):
+                mat[m:m + 2, :] = self._mzi(phases[index + k], phases[index + pairs + k] / 2) @ mat[m:m + 2, :]
+            index += 2 * pairs
+        return np.exp(1j * phases[index:])[:, None] * mat
+
     def decompose(self, u):
         
-        phis, thetas, alphas = self.decompose_clements(u)
-        #print(phis, thetas, alphas)
-        phases, size = self.flatten_phase(phis, thetas, alphas)
+        phases = self.getPhasesFromUnitary(u)
+        size = u.shape[0]
         #voltages = self.phases_to_norm_voltages(phases)
         self.voltages = self.getVoltagesFromPhases(phases)
         self.size = size